@@ -1,5 +1,8 @@
 #include "greedy_labeler.hpp"
 #include "visualizer.hpp"
+#include "csv_reader.hpp"
+#include "geo_tiles.hpp"
+#include "threshold_codec.hpp"
 
 #include <algorithm>
 #include <array>
@@ -28,10 +31,15 @@ int main(int argc, char** argv) {
     //   Random: [numPoints] [minDomain] [maxDomain] [shaderPath]
     //   CSV: --input=path/to/file.csv
     // Flags:
-    //   --input=FILE         load CSV (x,y[,side][,corner])
+    //   --input=FILE         load CSV (x,y[,side][,corner]) or csv_labeler --format q16 (.lq16)
     //   --shader=DIR         shader directory (default shaders)
     //   --base-size=SIZE     override per-point sizes, regenerate uniform candidates
     //   --cap-inf=SIZE       display cap for INF side values (default 5.0)
+    //   --x-col=C --y-col=C --side-col=C --corner-col=C
+    //                        column by header name or 0-based index (default 0, 1, then
+    //                        side/corner by name, or columns 2/3 in headerless files)
+    //   --delim=D            field delimiter , ; | tab (default detected from the first line)
+    //   --project=mercator   x/y are lon/lat degrees, view in Web Mercator meters
 
     int numPoints = 100000;
     float minDomain = -1.f;
@@ -40,6 +48,9 @@ int main(int argc, char** argv) {
     float baseOverride = -1.f;
     float infCap = 5.0f;
     std::string inputCSV;
+    std::string xCol = "0", yCol = "1", sideCol = "side|2", cornerCol = "corner|3";
+    CsvOptions csvOpts;
+    bool mercator = false;
 
     // First scan flags
     for (int i = 1; i < argc; ++i) {
@@ -48,6 +59,14 @@ int main(int argc, char** argv) {
         else if (a.rfind("--shader=",0)==0) shaderPath = a.substr(9);
         else if (a.rfind("--base-size=",0)==0) baseOverride = std::stof(a.substr(12));
         else if (a.rfind("--cap-inf=",0)==0) infCap = std::stof(a.substr(10));
+        else if (a.rfind("--x-col=",0)==0) xCol = a.substr(8);
+        else if (a.rfind("--y-col=",0)==0) yCol = a.substr(8);
+        else if (a.rfind("--side-col=",0)==0) sideCol = a.substr(11);
+        else if (a.rfind("--corner-col=",0)==0) cornerCol = a.substr(13);
+        else if (a == "--project=mercator") mercator = true;
+        else if (a.rfind("--delim=",0)==0) {
+            if (!parseCsvDelimiter(a.substr(8), csvOpts.delimiter)) std::cerr << "Ignoring invalid " << a << "\n";
+        }
     }
 
     bool csvMode = !inputCSV.empty();
@@ -66,46 +85,48 @@ int main(int argc, char** argv) {
     std::vector<LabelCandidate> candidates;
 
     if (csvMode) {
-        std::ifstream in(inputCSV);
-        if (!in) { std::cerr << "Could not open input CSV: " << inputCSV << "\n"; return -1; }
-        std::string line; bool first = true; size_t lineNum = 0;
         std::vector<float> perSide;
         std::vector<int> perCorner;
-        while (std::getline(in, line)) {
-            ++lineNum;
-            if (line.empty()) continue;
-            if (first) {
-                first = false;
-                bool hasAlpha = false; for (unsigned char c: line) { if (std::isalpha(c)) { hasAlpha = true; break; } }
-                if (hasAlpha) { // treat as header, skip
-                    continue;
-                }
-            }
-            std::replace(line.begin(), line.end(), ';', ',');
-            std::stringstream ss(line);
-            std::string xs, ys, sideStr, cornerStr;
-            if (!std::getline(ss, xs, ',')) continue;
-            if (!std::getline(ss, ys, ',')) continue;
-            // side & corner optional
-            std::getline(ss, sideStr, ',');
-            std::getline(ss, cornerStr, ',');
-
-            float x,y; if(!tryParseFloat(xs,x) || !tryParseFloat(ys,y)) continue;
-            points.push_back({x,y});
-
-            float s = (baseOverride > 0.f) ? baseOverride : 0.02f; // default
-            if (!sideStr.empty()) {
-                if (sideStr == "INF" || sideStr == "inf" || sideStr == "+inf" || sideStr == "+INF") s = infCap; else {
-                    float maybe; if (tryParseFloat(sideStr, maybe)) { if (maybe > 1e-4f) s = maybe; else s = 1e-4f; }
+        std::vector<double> xs, ys;
+        std::string err;
+        const bool lq16 = inputCSV.size() > 5 && inputCSV.compare(inputCSV.size() - 5, 5, ".lq16") == 0;
+        QuantizedLabelSet qset;
+        // Only the x/y/side/corner columns are sliced out of each row; others are skipped.
+        const bool ok = lq16 ? readQuantizedLabels(inputCSV, qset, &err) : forEachCsvRow(inputCSV, {xCol, yCol, sideCol, cornerCol},
+            [&](const std::vector<CsvField>& f) {
+                double x,y; if(!parseDoubleField(f[0],x) || !parseDoubleField(f[1],y)) return;
+                xs.push_back(x); ys.push_back(y);
+
+                // side & corner optional
+                const std::string sideStr = f[2].str(), cornerStr = f[3].str();
+                float s = (baseOverride > 0.f) ? baseOverride : 0.02f; // default
+                if (!sideStr.empty()) {
+                    if (sideStr == "INF" || sideStr == "inf" || sideStr == "+inf" || sideStr == "+INF") s = infCap; else {
+                        float maybe; if (tryParseFloat(sideStr, maybe)) { if (maybe > 1e-4f) s = maybe; else s = 1e-4f; }
+                    }
                 }
-            }
-            perSide.push_back(s);
-
-            int cidx = -1;
-            if (!cornerStr.empty()) { int maybe; if (tryParseInt(cornerStr, maybe)) cidx = maybe; }
-            perCorner.push_back(cidx);
+                perSide.push_back(s);
+
+                int cidx = -1;
+                if (!cornerStr.empty()) { int maybe; if (tryParseInt(cornerStr, maybe)) cidx = maybe; }
+                perCorner.push_back(cidx);
+            }, &err, csvOpts);
+        if (!ok) { std::cerr << "Could not read input CSV: " << err << "\n"; return -1; }
+        // Binary input: dequantize positions, decode packed size codes (code 0 = no label)
+        for (const auto& r : qset.records) {
+            xs.push_back(qset.originX + r.qx * qset.scaleX);
+            ys.push_back(qset.originY + r.qy * qset.scaleY);
+            const uint16_t code = labelCode(r.label);
+            perSide.push_back(baseOverride > 0.f ? baseOverride : (code ? decodeThreshold(qset.codec, code) : infCap));
+            perCorner.push_back(code ? labelCorner(r.label) : -1);
         }
 
+        // Same float32 frame as csv_labeler (keeps ~1e7 coordinates precise)
+        if (mercator && !lq16) projectLonLatToMercator(xs.data(), ys.data(), xs.size()); // .lq16 is stored projected
+        LocalFrame frame = buildLocalFrame(xs, ys);
+        points = std::move(frame.offsets);
+        std::cout << "Local origin: (" << frame.originX << ", " << frame.originY << ")\n";
+
         // Build candidates
         candidates.reserve(points.size()*4);
         for (size_t i=0;i<points.size();++i) {
@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file csv_reader.hpp
+ * @brief Column-selective CSV ingestion for wide point records.
+ *
+ * Overview:
+ *  - Columns are selected by header name or 0-based index ("x", "lon", "3"), or "name|index":
+ *    by name when the file has a header (absent name = missing column), by index when not.
+ *  - One delimiter per file: CsvOptions::delimiter, or detected from the first line (the most
+ *    frequent of ',' ';' tab '|' outside quotes; ',' when none occurs).
+ *  - Fields may be double-quoted ("a,b", "" escapes a quote); quoted fields keep delimiters.
+ *    Rows are single lines (no line breaks inside quotes).
+ *  - Each line is scanned once; only the requested fields are sliced out, the remaining
+ *    columns are skipped without conversion.
+ *  - The first line is a header when a column is selected by name only, or when a column
+ *    selected by index holds a non-empty, non-numeric field there ("nan" / "inf" / empty
+ *    fields count as data).
+ */
+
+/**
+ * @struct CsvOptions
+ * @brief Parsing options.
+ */
+struct CsvOptions {
+    char delimiter = 0; ///< Field delimiter; 0 = detect from the first line.
+};
+
+/**
+ * @struct CsvField
+ * @brief Slice of one field inside the current line (not null-terminated).
+ */
+struct CsvField {
+    const char* begin = nullptr; ///< First character (nullptr when the column is missing).
+    const char* end   = nullptr; ///< One past the last character.
+    bool empty() const { return begin == end; }
+    std::string str() const { return std::string(begin, end); }
+};
+
+/**
+ * @brief Parse a field as float (surrounding spaces allowed, "INF"/"nan" accepted).
+ * @param f   Field slice.
+ * @param out Parsed value (unchanged on failure).
+ * @return true if the whole field is a number.
+ */
+bool parseFloatField(const CsvField& f, float& out);
+
+/// @brief Same as parseFloatField, keeping double precision (large projected coordinates).
+bool parseDoubleField(const CsvField& f, double& out);
+
+/**
+ * @brief Resolve a column spec against the header.
+ * @param spec   Header name (case-insensitive), 0-based index, or "name|index".
+ * @param header Header fields (empty when the file has no header).
+ * @return Column index, or -1 if the name is unknown.
+ */
+int resolveCsvColumn(const std::string& spec, const std::vector<std::string>& header);
+
+/**
+ * @brief Pick the delimiter of a line: most frequent of ',' ';' '\t' '|' outside quotes.
+ * @return The delimiter (',' when none occurs; ties go to the earlier one in that list).
+ */
+char detectCsvDelimiter(const std::string& line);
+
+/**
+ * @brief Parse a delimiter option: one character, or "tab" / "\\t" for a tab.
+ * @return false if `s` names no single delimiter.
+ */
+bool parseCsvDelimiter(const std::string& s, char& out);
+
+/**
+ * @brief Split all fields of a line (quotes removed, "" unescaped, surrounding spaces trimmed).
+ */
+std::vector<std::string> splitCsvLine(const std::string& line, char delimiter);
+
+/**
+ * @brief Decide whether a first line is a header for the given column specs (see file doc).
+ */
+bool isCsvHeader(const std::vector<std::string>& firstLine, const std::vector<std::string>& specs);
+
+/**
+ * @brief Slice the requested columns out of one line.
+ *
+ * Scans up to the largest requested column and stops; later columns are never touched.
+ * Quoted fields are sliced without their quotes ("" escapes stay doubled).
+ *
+ * @param line      Line text (without newline).
+ * @param cols      Requested column indices (-1 = not requested, yields an empty field).
+ * @param out       Output slices, out[k] for cols[k] (resized to cols.size()).
+ * @param delimiter Field delimiter.
+ * @return Number of requested columns that were present in the line.
+ */
+int selectCsvFields(const std::string& line, const std::vector<int>& cols, std::vector<CsvField>& out,
+                    char delimiter = ',');
+
+/**
+ * @brief Stream a CSV file, handing only the selected fields of every data row to a callback.
+ * @param path   Input file.
+ * @param specs  Column specs (name or index); an empty spec is skipped (empty field).
+ * @param row    Callback receiving one field per spec (fields are valid during the call only).
+ * @param error  Optional error message (unopenable file / unknown column name).
+ * @param opts   Parsing options.
+ * @return false on error, true otherwise.
+ */
+bool forEachCsvRow(const std::string& path,
+                   const std::vector<std::string>& specs,
+                   const std::function<void(const std::vector<CsvField>&)>& row,
+                   std::string* error = nullptr,
+                   const CsvOptions& opts = CsvOptions{});
+
+/**
+ * @brief Load x/y (and optionally weight) columns as points.
+ * @param path     Input file.
+ * @param xCol     Spec of the x column (default first column).
+ * @param yCol     Spec of the y column (default second column).
+ * @param wCol     Spec of the weight column (empty = no weights).
+ * @param pts      Output points (appended; rows with unparsable x/y are skipped).
+ * @param weights  Output weights, one per point (1 when missing/unparsable); untouched if wCol empty.
+ * @param error    Optional error message.
+ * @param opts     Parsing options.
+ * @return false on error, true otherwise.
+ */
+bool readPointsCsvColumns(const std::string& path,
+                          const std::string& xCol, const std::string& yCol, const std::string& wCol,
+                          std::vector<std::array<float,2>>& pts,
+                          std::vector<float>& weights,
+                          std::string* error = nullptr,
+                          const CsvOptions& opts = CsvOptions{});
+
+/**
+ * @brief Double-precision variant: x/y into separate arrays (structure of arrays).
+ *
+ * Use with geo_tiles.hpp when coordinates are too large for float32 (e.g. Web Mercator).
+ */
+bool readPointsCsvColumns(const std::string& path,
+                          const std::string& xCol, const std::string& yCol, const std::string& wCol,
+                          std::vector<double>& xs, std::vector<double>& ys,
+                          std::vector<float>& weights,
+                          std::string* error = nullptr,
+                          const CsvOptions& opts = CsvOptions{});
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "greedy_labeler.hpp"
+
+/**
+ * @file engine_planner.hpp
+ * @brief Pick labeling backends (index, cell size, corner algorithm, threads) from data statistics.
+ *
+ * Overview:
+ *  - sampleDatasetStats() samples the input once (extent, N, cell-occupancy skew, duplicates).
+ *  - planEngine() turns those statistics into PlacementOptions + a threshold engine choice,
+ *    recording a human-readable reason for every decision.
+ */
+
+/**
+ * @struct DatasetStats
+ * @brief Cheap summary of a point set used by the planner.
+ */
+struct DatasetStats {
+    size_t n = 0;                       ///< Total number of points.
+    float  minX = 0.f, minY = 0.f;      ///< Extent (minimum corner).
+    float  maxX = 0.f, maxY = 0.f;      ///< Extent (maximum corner).
+    size_t sampled = 0;                 ///< Points actually inspected (strided sample).
+    float  occupancySkew = 0.f;         ///< Variance/mean of per-cell sample counts (~1 = uniform random).
+    float  duplicateRate = 0.f;         ///< Fraction of sampled points sharing coordinates with another.
+};
+
+/**
+ * @enum ThresholdEngine
+ * @brief Threshold search strategy used by csv_labeler.
+ *
+ *  - Search: independent per-size probes + batched refinement.
+ *  - Monotone: one descending sweep through a single MonotoneState.
+ */
+enum class ThresholdEngine { Search, Monotone };
+
+/**
+ * @struct EnginePlan
+ * @brief Planner decision: backends to use plus the statistics and reasons behind them.
+ */
+struct EnginePlan {
+    ThresholdEngine          engine = ThresholdEngine::Search; ///< Threshold engine.
+    PlacementOptions         placement;                        ///< Index / corners / threads.
+    DatasetStats             stats;                            ///< Statistics the plan is based on.
+    std::vector<std::string> reasons;                          ///< One line per decision.
+};
+
+/**
+ * @brief Sample a point set and compute planner statistics.
+ * @param pts        Input points.
+ * @param maxSamples Upper bound on inspected points (strided sample when N is larger).
+ * @return Statistics (all zero for an empty input).
+ */
+DatasetStats sampleDatasetStats(const std::vector<std::array<float,2>>& pts,
+                                size_t maxSamples = 65536);
+
+/**
+ * @brief Choose engine, spatial index, corner cell size, corner algorithm and thread count.
+ * @param pts             Input points.
+ * @param hardwareThreads Available hardware threads (0 = query std::thread).
+ * @return Plan with reasons for each choice.
+ */
+EnginePlan planEngine(const std::vector<std::array<float,2>>& pts,
+                      unsigned hardwareThreads = 0);
+
+/**
+ * @brief Corner-selection threads planEngine picks for `n` points (1 below its parallel cutoff).
+ * @param hardwareThreads Available hardware threads (0 = query std::thread).
+ */
+int plannedCornerThreads(size_t n, unsigned hardwareThreads = 0);
+
+/// @brief Short names for reporting ("search", "grid", "clearance-grid", ...).
+const char* toString(ThresholdEngine e);
+const char* toString(RectIndexKind k);
+const char* toString(CornerPolicy p);
@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file geo_tiles.hpp
+ * @brief Double-precision frame origin + float32 local offsets for large-magnitude coordinates.
+ *
+ * Overview:
+ *  - Projected coordinates (e.g. Web Mercator meters, ~1e7) only keep ~1 m precision in float32.
+ *  - Inputs are parsed as double and stored as float32 offsets from one double origin at the
+ *    extent center, so hot paths stay float32 without losing precision. Labeling needs one
+ *    shared frame: conflicts are tested between any two points.
+ *  - Data already centered near zero keeps its input coordinates (origin 0, see buildLocalFrame).
+ *  - planQuantizedTiles/quantizeTile store points as 16-bit offsets within grid tiles (drawing).
+ */
+
+/**
+ * @struct LocalFrame
+ * @brief Points as float32 offsets from a double origin, in input order.
+ */
+struct LocalFrame {
+    double originX = 0.0, originY = 0.0;      ///< Frame origin in input (projected) units.
+    std::vector<std::array<float,2>> offsets; ///< Point minus origin, input order.
+};
+
+/**
+ * @brief Project lon/lat degrees to Web Mercator meters in place (EPSG:3857).
+ *
+ * Structure-of-arrays passes; the x pass is a plain scale, the y pass calls std::sin/std::log per
+ * point (scalar libm calls, not vectorized without a vector math library). Latitudes are clamped
+ * to the Mercator limit (+-85.05112878 deg).
+ *
+ * @param x Longitudes in, x meters out (n values).
+ * @param y Latitudes in, y meters out (n values).
+ * @param n Number of points.
+ */
+void projectLonLatToMercator(double* x, double* y, size_t n);
+
+/**
+ * @brief Express points as float32 offsets from the center of their extent.
+ *
+ * A center within 8 extents of zero costs at most ~4 bits in input coordinates, so such data
+ * (e.g. unit-square or [0,100] sets) keeps origin (0, 0): shifting it gains no precision and only
+ * rounds differently, which moves corner tie-breaks. csv_labeler, csv_raster and the viewer all
+ * use this frame, so their label geometry matches.
+ *
+ * @param xs X coordinates (double).
+ * @param ys Y coordinates (double, same size as xs).
+ * @return Origin and offsets (empty for empty input).
+ */
+LocalFrame buildLocalFrame(const std::vector<double>& xs, const std::vector<double>& ys);
+
+/**
+ * @struct QuantizedTile
+ * @brief One tile of 16-bit positions: point = origin + q / 65535 * scale.
+ */
+struct QuantizedTile {
+    float    originX = 0.f, originY = 0.f; ///< Tile bounds minimum (in the points' frame).
+    float    scaleX = 0.f, scaleY = 0.f;   ///< Tile bounds extent (0 when all points coincide).
+    uint32_t begin = 0;                    ///< First stored point of this tile.
+    uint32_t count = 0;                    ///< Number of stored points.
+};
+
+/**
+ * @struct QuantizedTileLayout
+ * @brief 16-bit point tiles before quantization: per-tile transforms + tile-major indices.
+ */
+struct QuantizedTileLayout {
+    std::vector<QuantizedTile> tiles; ///< Non-empty tiles.
+    std::vector<uint32_t> order;      ///< order[k] = input index of stored point k (tile-major).
+};
+
+/**
+ * @brief Assign points to square grid tiles and compute each tile's transform.
+ *
+ * Counting-sorts point indices (4 bytes per point); the points themselves are not copied.
+ * Each tile spans the bounding box of its own points, so precision is tile extent / 65535.
+ *
+ * @param pts          Points.
+ * @param tilesPerAxis Grid resolution over the extent (<= 0: chosen from N, ~16k points per tile).
+ */
+QuantizedTileLayout planQuantizedTiles(const std::vector<std::array<float,2>>& pts, int tilesPerAxis = 0);
+
+/**
+ * @brief Quantize one tile's points into q[0..t.count) (e.g. a staging buffer for one upload).
+ * @param pts    Points passed to planQuantizedTiles.
+ * @param layout Layout from planQuantizedTiles.
+ * @param t      One of layout.tiles.
+ * @param q      Output, t.count entries.
+ */
+void quantizeTile(const std::vector<std::array<float,2>>& pts, const QuantizedTileLayout& layout,
+                  const QuantizedTile& t, std::array<uint16_t,2>* q);
@@ -1,5 +1,7 @@
 #pragma once
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 /**
@@ -40,6 +42,10 @@ struct LabelCandidate {
     bool   valid;               ///< True if chosen by the placement pass.
 };
 
+struct PointGrid;      ///< Point hash grid (defined in greedy_labeler.cpp).
+struct PlacementCache; ///< Zoom-out label index (defined in greedy_labeler.cpp).
+struct NumaTopology;   ///< Node CPUs (numa_topology.hpp).
+
 /**
  * @struct MonotoneState
  * @brief Persistent state to support monotone label placement across size/zoom changes.
@@ -49,12 +55,71 @@ struct LabelCandidate {
  *  - active: indices of candidates currently placed.
  *  - fixedCorner: per point chosen corner (stabilizes layout).
  *  - usedOnce: marks points that have ever received a label (optional policy).
+ *  - pointIndex: point grid kept between calls while its cell (the power of two in
+ *    (baseSize, 2 baseSize]) stays the same; placement results never depend on it.
+ *  - placement: active-label index and density order carried across zoom-out calls on the same
+ *    point grid, so a descending sweep only inserts new activations.
+ *
+ * A state is bound to one point set. When the point contents change, reset pointIndex (which
+ * also drops placement) or the whole state (assign {}); the caches do not detect edits in place.
  */
 struct MonotoneState {
     float lastBase = -1.0f;                 ///< Previous base label size (<0 means uninitialized).
     std::vector<int> active;                ///< Candidate indices active after last placement.
     std::vector<int> fixedCorner;           ///< Chosen corner (0..3) per point.
     std::vector<unsigned char> usedOnce;    ///< 1 if point labeled at least once.
+    std::shared_ptr<const PointGrid> pointIndex; ///< Cached point grid (rebuilt when stale).
+    std::shared_ptr<PlacementCache> placement;   ///< Zoom-out index (rebuilt if shared by a copy).
+};
+
+/**
+ * @enum RectIndexKind
+ * @brief Spatial index used for placed-label overlap tests.
+ *
+ *  - Grid: uniform hash grid with cell = label size (uniform data).
+ *  - Quadtree: adaptive quadtree over the point extent.
+ *  - Linear: plain scan over placed labels (tiny inputs).
+ */
+enum class RectIndexKind { Grid, Quadtree, Linear };
+
+/**
+ * @enum CornerPolicy
+ * @brief Algorithm used to pick each point's fixed corner (largest orthant clearance, i.e.
+ *        Chebyshev distance to the nearest point inside that corner's quadrant).
+ *
+ *  - ClearanceGrid: ring scan over a point grid of cornerCellSize (exact: same corners for any cell).
+ *  - ClearanceBrute: all-pairs scan (O(N^2), cheapest for tiny inputs).
+ */
+enum class CornerPolicy { ClearanceGrid, ClearanceBrute };
+
+/**
+ * @struct ParallelStats
+ * @brief Locality counters of the parallel corner-selection phase (accumulated across calls).
+ */
+struct ParallelStats {
+    int      runs = 0;            ///< Parallel phases executed.
+    int      numaNodes = 1;       ///< Nodes used by the last run (1 = plain, unpartitioned).
+    int      threads = 0;         ///< Workers launched (all runs).
+    int      pinnedThreads = 0;   ///< Workers pinned to their node (all runs).
+    uint64_t items = 0;           ///< Points processed.
+    uint64_t localItems = 0;      ///< Points processed on a CPU of their slice's node (sampled).
+    uint64_t replicaBytes = 0;    ///< Node-local slab+halo point/grid replica memory (all runs).
+    uint64_t haloMisses = 0;      ///< Points whose scans left their node's halo (redone on a full grid).
+};
+
+/**
+ * @struct PlacementOptions
+ * @brief Backend selection for greedyPlaceMonotone (defaults match the original behavior).
+ */
+struct PlacementOptions {
+    RectIndexKind rectIndex = RectIndexKind::Grid;     ///< Index for placed-label overlap tests.
+    CornerPolicy  corners   = CornerPolicy::ClearanceGrid; ///< Fixed-corner selection algorithm.
+    float cornerCellSize = 0.05f;                      ///< Cell size of the corner-clearance grid.
+    int   threads = 1;                                 ///< Worker threads for corner selection.
+    bool  numa = true;            ///< With threads > 1 on multi-node machines: one spatial slab
+                                  ///< per node, pinned workers, node-local point/grid replicas.
+    const NumaTopology* topology = nullptr; ///< Node layout for `numa` (nullptr = numaTopology()).
+    ParallelStats* stats = nullptr;                    ///< Optional locality counters (out).
 };
 
 /**
@@ -92,16 +157,34 @@ greedyPlaceOneLabelPerPoint(std::vector<LabelCandidate>& candidates,
  *
  * Behavior:
  *  - If baseSize increases (zoom in): retain subset of previously valid labels that remain feasible.
- *  - If baseSize decreases (zoom out): attempt to add more labels without removing existing ones.
+ *  - If baseSize decreases (zoom out): attempt to add more labels without removing existing ones
+ *    (a shrinking label stays feasible, so existing ones are not re-checked).
  *
  * @param candidates  Candidate list (corner & size updated; valid flags written).
  * @param points      Input points (same order as used for candidate generation).
  * @param baseSize    Current label size.
  * @param state       Persistent state pointer (must outlive repeated calls).
+ * @param opts        Index / corner-selection backends (only read when corners are (re)computed
+ *                    and when building the per-call rect index).
  * @return Vector of placed Rects for this invocation.
  */
 std::vector<Rect>
 greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
                     const std::vector<std::array<float,2>>& points,
                     float baseSize,
-                    MonotoneState* state); // Use a pointer to the state
+                    MonotoneState* state, // Use a pointer to the state
+                    const PlacementOptions& opts = PlacementOptions{});
+
+/**
+ * @brief Whether a zoom-out greedyPlaceMonotone call at baseSize would add any label.
+ *
+ * Only the state's caches (pointIndex, placement) are updated; the active set and lastBase are
+ * unchanged. Returns true when baseSize is not below state->lastBase (nothing to predict).
+ *
+ * @param points   Input points (as passed to greedyPlaceMonotone).
+ * @param baseSize Candidate smaller label size.
+ * @param state    State of the previous greedyPlaceMonotone call.
+ * @param opts     Same options as the placement calls.
+ */
+bool monotoneZoomOutAddsLabels(const std::vector<std::array<float,2>>& points, float baseSize,
+                               MonotoneState* state, const PlacementOptions& opts = PlacementOptions{});
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "csv_reader.hpp"
+
+/**
+ * @file memory_model.hpp
+ * @brief Peak-memory estimate of one csv_labeler run, for admission control of batch jobs.
+ *
+ * Overview:
+ *  - Estimate = fixed process overhead + bytes-per-point x points, where bytes-per-point adds up
+ *    the structures alive at the peak (input arrays, candidates, point/rect grids, engine state).
+ *  - Corner selection on several threads adds per-thread overhead and, split over NUMA nodes,
+ *    the node replicas (about one more copy of the points and their grid, see greedy_labeler.cpp).
+ *  - Row counts come from the file size and a sample of its first lines; an exact count costs a
+ *    full read and is only needed when the estimates decide admission.
+ *  - Measured peak RSS of finished runs is appended to a calibration file; the worst observed
+ *    actual/estimated ratio (plus a margin) of runs with the same engine and thread count scales
+ *    later estimates.
+ *  - Batch admission (nextBatchJob) starts the largest pending file that fits next to the running
+ *    ones; a file over the whole budget runs alone once nothing else is running.
+ */
+
+/**
+ * @struct MemoryModel
+ * @brief Bytes-per-point breakdown (see memory_model.cpp for the derivation).
+ */
+struct MemoryModel {
+    size_t baseBytes;         ///< Process baseline (runtime, stdio buffers, small tables, threads).
+    size_t inputPerPoint;     ///< Parsed double x/y, float32 points, local-frame order, weights.
+    size_t candidatePerPoint; ///< 4 candidates per probe + the 4 output candidates.
+    size_t gridPerPoint;      ///< Point grid (cached) + rect grid, hash nodes and buckets.
+    size_t enginePerPoint;    ///< Thresholds/intervals (search) or monotone state + probe copies.
+    size_t parallelPerPoint;  ///< NUMA split: x order + node-local point/grid replicas (else 0).
+    size_t perPoint() const {
+        return inputPerPoint + candidatePerPoint + gridPerPoint + enginePerPoint + parallelPerPoint;
+    }
+};
+
+/**
+ * @brief Model for an engine ("search", "monotone" or "auto"; auto assumes the larger one).
+ * @param threads   Corner-selection threads (PlacementOptions::threads).
+ * @param numaNodes NUMA nodes of the machine (numaTopology().nodeCount()); replicas are
+ *                  counted when threads > 1 and numaNodes > 1.
+ * @param weighted  A weight column is read (--weight-col): one float per point, kept to the end.
+ *
+ * The output format is not a parameter: both writers run after labeling has released the probe
+ * candidates and grids, and the larger one (.lq16: double x/y plus an 8-byte record per point)
+ * stays below the labeling peak.
+ */
+MemoryModel memoryModelFor(const std::string& engine, int threads = 1, int numaNodes = 1, bool weighted = false);
+
+/**
+ * @brief Uncalibrated peak estimate in bytes for `points` points.
+ */
+uint64_t estimatePeakBytes(size_t points, const std::string& engine, int threads = 1, int numaNodes = 1,
+                           bool weighted = false);
+
+/**
+ * @brief Batch admission: the pending job to start next.
+ * @param pending  Estimates of the pending jobs in admission order (largest first).
+ * @param inUse    Summed estimates of the running jobs.
+ * @param running  Number of running jobs.
+ * @param maxJobs  Concurrency cap (--jobs).
+ * @param memLimit Budget for the summed estimates (--mem-limit).
+ * @return Index into `pending` of the first job that fits the budget, or -1 to wait for a
+ *         running job to finish. With nothing running, a job over the whole budget is started
+ *         anyway (it runs alone), so the queue cannot stall.
+ */
+long nextBatchJob(const std::vector<uint64_t>& pending, uint64_t inUse, size_t running, int maxJobs,
+                  uint64_t memLimit);
+
+/**
+ * @brief Count data rows of a CSV: non-empty lines, minus the first one when csv_reader
+ *        treats it as a header for these column specs (isCsvHeader).
+ * @return Row count, or 0 if the file cannot be read.
+ */
+size_t countCsvRows(const std::string& path, const std::vector<std::string>& specs,
+                    const CsvOptions& opts = CsvOptions{});
+
+/**
+ * @struct CsvRowEstimate
+ * @brief Row count guessed from the file size.
+ */
+struct CsvRowEstimate {
+    size_t rows = 0;    ///< Data rows (exact when `exact`).
+    bool   exact = false; ///< The sample covered the whole file.
+};
+
+/**
+ * @brief Estimate data rows from the file size and the mean row length of its first
+ *        `sampleBytes` (header rule as countCsvRows).
+ * @return Estimate (rows = 0 if the file cannot be read).
+ */
+CsvRowEstimate estimateCsvRows(const std::string& path, const std::vector<std::string>& specs,
+                               const CsvOptions& opts = CsvOptions{}, size_t sampleBytes = 1 << 16);
+
+/**
+ * @struct MemoryCalibration
+ * @brief Correction learned from previous runs.
+ */
+struct MemoryCalibration {
+    double ratio = 1.0; ///< Multiplier applied to estimates (1.5 before the first sample).
+    int    samples = 0; ///< Runs the ratio is based on.
+};
+
+/**
+ * @brief Load the calibration of one engine / thread count (missing file or no matching
+ *        records = cold-start ratio 1.5, no samples).
+ *
+ * ratio = 1.1 x the largest actual/estimated ratio among the most recent 64 matching records,
+ * so one under-estimated file raises all later estimates, and over-estimates shrink them again
+ * once they age out. Records without engine and threads fields are ignored.
+ */
+MemoryCalibration loadMemoryCalibration(const std::string& path, const std::string& engine, int threads);
+
+/**
+ * @brief Append one measured run ("points,estimated_bytes,peak_rss_bytes,engine,threads",
+ *        header on creation).
+ * @return false if the file cannot be written.
+ */
+bool appendMemoryCalibration(const std::string& path, size_t points,
+                             uint64_t estimatedBytes, uint64_t peakRssBytes,
+                             const std::string& engine, int threads);
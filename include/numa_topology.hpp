@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @file numa_topology.hpp
+ * @brief NUMA node discovery and thread pinning for the parallel placement phases.
+ *
+ * Overview:
+ *  - Linux: nodes and their CPUs come from /sys/devices/system/node/node<N>/cpulist, restricted
+ *    to the CPUs this process may run on; pinning uses sched_setaffinity.
+ *  - Elsewhere (or without sysfs) the machine is reported as one node and pinning is a no-op,
+ *    so callers fall back to their plain code path.
+ */
+
+/**
+ * @struct NumaTopology
+ * @brief CPUs per NUMA node (nodes without usable CPUs are dropped).
+ */
+struct NumaTopology {
+    std::vector<int>              nodeIds;  ///< Kernel node id per entry.
+    std::vector<std::vector<int>> nodeCpus; ///< Usable CPUs per entry.
+    int nodeCount() const { return (int)nodeCpus.size(); }
+};
+
+/**
+ * @brief Read the topology from a sysfs node directory.
+ * @param sysRoot Directory holding node<N>/cpulist entries.
+ * @return Topology (empty when unavailable).
+ */
+NumaTopology loadNumaTopology(const std::string& sysRoot = "/sys/devices/system/node");
+
+/**
+ * @brief Process-wide topology, loaded once.
+ */
+const NumaTopology& numaTopology();
+
+/**
+ * @brief Pin the calling thread to the CPUs of topology entry `node`.
+ * @return true if the affinity was set.
+ */
+bool pinCurrentThreadToNode(const NumaTopology& topo, int node);
+
+/**
+ * @brief Topology entry of the CPU the calling thread is running on (-1 if unknown).
+ */
+int currentNumaNode(const NumaTopology& topo);
@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file shared_dataset.hpp
+ * @brief Point datasets in POSIX shared memory, labeled in place by another process.
+ *
+ * Overview:
+ *  - A client creates a segment (shm_open name, or an anonymous memfd on Linux whose fd can be
+ *    passed over a Unix socket or inherited by a child, `csv_labeler fd:N`), writes float32
+ *    points into it and sets state Ready.
+ *  - The labeler maps the same segment, copies the points once into its working array (one
+ *    memcpy, no parsing) and writes one result per point directly into the output region, then
+ *    sets state Done (or Failed, see SharedLabelingGuard). Only the handle (name / fd) crosses
+ *    the process boundary; no socket or file transfer grows with the dataset.
+ *  - Layout: SharedDatasetHeader | points (float x,y) | results (SharedLabelResult), 64-byte aligned.
+ *  - Points are labeled as stored. For data far from zero, write offsets from a local origin
+ *    (buildLocalFrame(xs, ys)) to get the frame csv_labeler uses for such CSV input.
+ *  - On non-POSIX platforms every function fails with an error message.
+ */
+
+/// @brief Segment state, advanced by the client (Ready) and the labeler (Labeling, Done/Failed).
+enum SharedDatasetState : uint32_t {
+    kSharedEmpty    = 0, ///< Created; client is filling points.
+    kSharedReady    = 1, ///< Points complete, waiting for the labeler.
+    kSharedLabeling = 2, ///< Labeler is working.
+    kSharedDone     = 3, ///< Results valid.
+    kSharedFailed   = 4  ///< Labeler gave up (results undefined).
+};
+
+/**
+ * @struct SharedDatasetHeader
+ * @brief Fixed header at offset 0 of the segment.
+ */
+struct SharedDatasetHeader {
+    char     magic[4];                ///< "PGSD".
+    uint32_t version;                 ///< Layout version (1).
+    uint64_t count;                   ///< Number of points.
+    uint64_t pointsOffset;            ///< Byte offset of the point array.
+    uint64_t resultsOffset;           ///< Byte offset of the result array.
+    uint64_t bytes;                   ///< Total segment size.
+    std::atomic<uint32_t> state;      ///< SharedDatasetState.
+};
+
+/**
+ * @struct SharedLabelResult
+ * @brief Labeler output per point (input order).
+ */
+struct SharedLabelResult {
+    float   size;   ///< Label threshold (0 = no label).
+    int32_t corner; ///< Chosen corner 0..3 (-1 = no label).
+};
+
+/**
+ * @struct SharedDataset
+ * @brief A mapped segment (views into the mapping; valid until closeSharedDataset()).
+ */
+struct SharedDataset {
+    void*                 base = nullptr;    ///< Mapping start.
+    size_t                bytes = 0;         ///< Mapping size.
+    int                   fd = -1;           ///< Segment file descriptor.
+    SharedDatasetHeader*  header = nullptr;  ///< Header view.
+    std::array<float,2>*  points = nullptr;  ///< header->count points.
+    SharedLabelResult*    results = nullptr; ///< header->count results.
+    size_t count() const { return header ? (size_t)header->count : 0; }
+};
+
+/**
+ * @brief Create and map a segment for `count` points (state kSharedEmpty).
+ * @param name  POSIX shm name ("/pg_points"); empty = anonymous memfd (Linux only, pass ds.fd).
+ * @param count Number of points.
+ * @param ds    Output mapping.
+ * @param error Optional error message.
+ * @return false on error (name already exists, no memory, unsupported platform).
+ */
+bool createSharedDataset(const std::string& name, size_t count, SharedDataset& ds, std::string* error = nullptr);
+
+/**
+ * @brief Map an existing segment by shm name and validate its header.
+ */
+bool openSharedDataset(const std::string& name, SharedDataset& ds, std::string* error = nullptr);
+
+/**
+ * @brief Map an existing segment from a file descriptor (e.g. a memfd received over a socket).
+ *
+ * The descriptor is duplicated; the caller keeps ownership of `fd`.
+ */
+bool openSharedDatasetFd(int fd, SharedDataset& ds, std::string* error = nullptr);
+
+/**
+ * @brief Unmap and close (the segment itself persists until unlinked / last fd closed).
+ */
+void closeSharedDataset(SharedDataset& ds);
+
+/**
+ * @brief Remove a named segment (shm_unlink).
+ */
+bool unlinkSharedDataset(const std::string& name);
+
+/**
+ * @class SharedLabelingGuard
+ * @brief Claims a Ready segment for labeling (Ready -> Labeling) and guarantees a final state.
+ *
+ * Unless done() publishes kSharedDone, the destructor stores kSharedFailed, so every return
+ * (or unwinding exception) after a successful claim leaves the segment Failed instead of
+ * stuck in Labeling. A failed claim leaves the state untouched.
+ */
+class SharedLabelingGuard {
+public:
+    /// @brief Try the claim; ds must stay mapped for the guard's lifetime.
+    explicit SharedLabelingGuard(SharedDataset& ds);
+    ~SharedLabelingGuard();
+    SharedLabelingGuard(const SharedLabelingGuard&) = delete;
+    SharedLabelingGuard& operator=(const SharedLabelingGuard&) = delete;
+
+    bool claimed() const { return claimed_; }            ///< True if the segment was Ready.
+    uint32_t observedState() const { return observed_; } ///< State found when the claim failed.
+    /// @brief Publish kSharedDone (release) after the results are written.
+    void done();
+
+private:
+    SharedDataset& ds_;
+    bool claimed_ = false;
+    bool finished_ = false;
+    uint32_t observed_ = kSharedReady;
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file threshold_codec.hpp
+ * @brief Compact label encoding: 16-bit log-scale threshold + 2-bit corner in 4 bytes.
+ *
+ * Overview:
+ *  - A threshold s in [smin, smax] maps to code 1..65535 on a log scale (constant relative
+ *    step (smax/smin)^(1/65534)); code 0 means "no label", and sizes below smin encode to 0.
+ *  - Encoding rounds down, so a decoded threshold never exceeds the encoded size and lies
+ *    within one relative step below it.
+ *  - Positions are quantized too (up to half a step per axis, step = extent / 65535), so
+ *    quantizeLabels() lowers each threshold by the larger position step before encoding.
+ *    Drawn at any size S up to its decoded threshold, a decoded label then overlaps another
+ *    decoded label or point only where the exact layout already conflicts at S + step.
+ *  - packLabel() puts the code in bits 0..15 and the corner in bits 16..17 of a uint32.
+ *  - The ".lq16" file stores one 8-byte record per point: 16-bit quantized x/y + packed label.
+ *    Positions are in the coordinates the thresholds were computed in (projected, if any).
+ */
+
+/**
+ * @struct ThresholdCodec
+ * @brief Log-scale quantizer for label sizes between smin and smax.
+ */
+struct ThresholdCodec {
+    float smin = 1e-4f;     ///< Smallest representable size (code 1).
+    float smax = 1.f;       ///< Largest representable size (code 65535).
+    float logMin = 0.f;     ///< log(smin).
+    float logRange = 0.f;   ///< log(smax) - log(smin).
+};
+
+/**
+ * @brief Build a codec for [smin, smax] (smin clamped > 0, smax >= smin).
+ */
+ThresholdCodec makeThresholdCodec(float smin, float smax);
+
+/**
+ * @brief Encode a size (rounded down). Non-finite sizes and sizes below smin encode to 0 (no label).
+ */
+uint16_t encodeThreshold(const ThresholdCodec& c, float size);
+
+/**
+ * @brief Decode a code back to a size (code 0 decodes to 0.f, i.e. "no label").
+ */
+float decodeThreshold(const ThresholdCodec& c, uint16_t code);
+
+/// @brief Pack code (bits 0..15) and corner 0..3 (bits 16..17) into 4 bytes.
+inline uint32_t packLabel(uint16_t code, int corner) {
+    return (uint32_t)code | ((uint32_t)(corner & 3) << 16);
+}
+/// @brief Threshold code of a packed label.
+inline uint16_t labelCode(uint32_t packed) { return (uint16_t)(packed & 0xFFFFu); }
+/// @brief Corner (0..3) of a packed label.
+inline int labelCorner(uint32_t packed) { return (int)((packed >> 16) & 3u); }
+
+/**
+ * @struct QuantizedLabelRecord
+ * @brief One point in an .lq16 file (8 bytes).
+ */
+struct QuantizedLabelRecord {
+    uint16_t qx, qy;   ///< Position quantized over the file extent.
+    uint32_t label;    ///< packLabel(code, corner).
+};
+
+/**
+ * @struct QuantizedLabelSet
+ * @brief Contents of an .lq16 file.
+ *
+ * Position i decodes to (originX + qx * scaleX, originY + qy * scaleY).
+ */
+struct QuantizedLabelSet {
+    ThresholdCodec codec;                      ///< Threshold range.
+    double originX = 0.0, originY = 0.0;       ///< Extent minimum corner.
+    double scaleX = 1.0, scaleY = 1.0;         ///< Extent / 65535 per axis.
+    std::vector<QuantizedLabelRecord> records; ///< One record per point.
+};
+
+/**
+ * @brief Quantize positions + thresholds into a QuantizedLabelSet.
+ *
+ * Unlabeled points get code 0 whatever their size. Thresholds are lowered by max(scaleX, scaleY)
+ * (the position rounding bound, see above) before encoding, so points whose threshold is within
+ * one position step of smin get no label either.
+ *
+ * @param xs, ys  Point coordinates the thresholds were computed in (double, same size; e.g.
+ *                projected meters, not lon/lat).
+ * @param sizes   Threshold per point (non-finite / below smin = no label).
+ * @param corners Corner per point (0..3).
+ * @param labeled Per point: 0 = never labeled (code 0).
+ * @param codec   Threshold codec.
+ */
+QuantizedLabelSet quantizeLabels(const std::vector<double>& xs, const std::vector<double>& ys,
+                                 const std::vector<float>& sizes, const std::vector<int>& corners,
+                                 const std::vector<unsigned char>& labeled, const ThresholdCodec& codec);
+
+/**
+ * @brief Write an .lq16 file (little-endian header + raw records).
+ * @return false if the file cannot be written.
+ */
+bool writeQuantizedLabels(const std::string& path, const QuantizedLabelSet& set);
+
+/**
+ * @brief Read an .lq16 file.
+ * @param error Optional error message (unopenable file / bad magic / truncated / record count
+ *              larger than the file).
+ * @return false on error.
+ */
+bool readQuantizedLabels(const std::string& path, QuantizedLabelSet& set, std::string* error = nullptr);
@@ -6,7 +6,7 @@
  *
  * Responsibilities:
  *  - Own window + GL context (GLFW) and immediate-mode GUI (ImGui).
- *  - Manage GPU buffers for points and label quads.
+ *  - Manage GPU buffers for points (16-bit per-tile positions) and label instances (anchor + packed 16-bit size code).
  *  - Re-run monotone label placement when zoom / base size changes.
  *  - Render points, labels, and UI per frame.
  */
@@ -15,6 +15,7 @@
 #include <array>
 #include <string>
 #include "greedy_labeler.hpp"
+#include "geo_tiles.hpp"
 
 // Prevent GLFW from including legacy OpenGL headers
 #define GLFW_INCLUDE_NONE
@@ -98,9 +99,9 @@ private:
     GLuint compileShader(GLenum type, const std::string& src) const; ///< Compile single shader stage.
     GLuint linkProgram(const std::string& vertPath, const std::string& fragPath) const; ///< Build program from files.
     void   loadShaders();        ///< Compile/link point + label programs.
-    void   buildPointBuffer();   ///< Create / fill VBO/VAO for points.
-    void   buildLabelBuffer();   ///< Create VAO/VBO for label quads (initial).
-    void   updateLabelBuffer();  ///< Update label quad data after placement.
+    void   buildPointBuffer();   ///< Create / fill VBO/VAO for points (quantized tiles).
+    void   buildLabelBuffer();   ///< Create VAO/VBO for label instances (initial).
+    void   updateLabelBuffer();  ///< Update label instance data after placement.
 
     // ---- Frame rendering ----
     void renderFrame();          ///< Draw one frame (points, labels, UI).
@@ -121,6 +122,7 @@ private:
     // Point geometry
     GLuint ptsVAO_ = 0;
     GLuint ptsVBO_ = 0;
+    std::vector<QuantizedTile> ptTiles_; ///< Per-tile transform + range in ptsVBO_.
 
     // Label geometry
     GLuint sqVAO_ = 0;
@@ -129,10 +131,18 @@ private:
     // Uniform locations
     GLint  uViewPt_ = -1;
     GLint  uViewSq_ = -1;
+    GLint  uTileOriginPt_ = -1;  ///< Point tile transform (origin + q * scale).
+    GLint  uTileScalePt_ = -1;
+    GLint  uLogMinSq_ = -1;      ///< Label size decoding (see threshold_codec.hpp).
+    GLint  uLogRangeSq_ = -1;
+
+    // Size codec of the uploaded label instances
+    float  sqLogMin_ = 0.0f;
+    float  sqLogRange_ = 0.0f;
 
     // Counts
     int    ptsCount_ = 0;        ///< Number of points.
-    int    sqCount_ = 0;         ///< Number of label quads (valid + invalid if drawn).
+    int    sqCount_ = 0;         ///< Number of label instances (valid candidates).
 
     // View / interaction
     float  zoom_ = 1.0f;         ///< Current zoom factor (affects baseSize_).
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include "greedy_labeler.hpp"
+
+/**
+ * @file zoom_thresholds.hpp
+ * @brief Per-point zoom thresholds: the largest label size at which each point keeps its label.
+ *
+ * Overview:
+ *  - computeZoomThresholds(): independent placements at probed sizes (geometric pre-sampling,
+ *    coarse growth, then refinement: batched median probes for an absolute eps, or with a
+ *    relative tolerance one probe per cluster of log intervals per round until every
+ *    hi/lo <= 1+tolRel).
+ *  - computeZoomThresholdsMonotone(): one descending sweep through a single MonotoneState.
+ *    A point's threshold is the size at which its final, uninterrupted activation began, so
+ *    the labels shown at any size S (all points with threshold >= S, drawn at size S) are a
+ *    subset of a placement the sweep made at a size >= S and never overlap.
+ *  - Points that never receive a label keep threshold Smin and labeled = 0; a point labeled
+ *    only at Smin also has threshold Smin, so only `labeled` tells the two apart.
+ */
+
+/**
+ * @struct ThresholdResult
+ * @brief Threshold and corner per point plus run counters.
+ */
+struct ThresholdResult {
+    std::vector<float> size;   ///< Threshold per point (Smin when never labeled).
+    std::vector<int>   corner; ///< Corner chosen at the threshold.
+    std::vector<unsigned char> labeled; ///< 1 if the point has a label at its threshold.
+    std::vector<float> upper;  ///< computeZoomThresholds: smallest probed size above the threshold
+                               ///< where the point was unlabeled (hi of its final interval).
+    int growthRuns = 0;        ///< Greedy runs during growth (monotone: coarse steps + probes).
+    int refineRuns = 0;        ///< Greedy runs during refinement (monotone: fine sub-steps).
+    int sweepRuns = 0;         ///< Optional multi-sample passes.
+};
+
+/**
+ * @brief Hybrid search: geometric pre-sampling, coarse growth and batched refinement.
+ * @param pts          Points (local frame).
+ * @param Smin, Smax   Size range.
+ * @param eps          Absolute interval tolerance (used when tolRel == 0).
+ * @param growth       Geometric growth factor of the coarse phase.
+ * @param maxGrowth    Max coarse growth iterations.
+ * @param maxRefine    Max refinement probes.
+ * @param multiSample  Enable the geometric pre-sampling pass.
+ * @param multiSamples Pre-sample count (0 = from growth and the size range).
+ * @param tolRel       >0: bisect in log space until hi/lo <= 1+tolRel.
+ * @param opts         Placement backends.
+ */
+ThresholdResult computeZoomThresholds(const std::vector<std::array<float,2>>& pts,
+                                      float Smin, float Smax,
+                                      float eps, float growth,
+                                      int maxGrowth, int maxRefine,
+                                      bool multiSample, int multiSamples,
+                                      float tolRel, const PlacementOptions& opts);
+
+/**
+ * @brief Descending monotone sweep from Smax to Smin.
+ * @param pts         Points (local frame).
+ * @param Smin, Smax  Size range.
+ * @param growth      Coarse step factor (the step count is capped by maxGrowth).
+ * @param maxGrowth   Max coarse steps.
+ * @param refineSteps Sub-steps per coarse step that changes the active set.
+ * @param opts        Placement backends.
+ */
+ThresholdResult computeZoomThresholdsMonotone(const std::vector<std::array<float,2>>& pts,
+                                              float Smin, float Smax,
+                                              float growth, int maxGrowth,
+                                              int refineSteps, const PlacementOptions& opts);
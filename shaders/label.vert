@@ -1,24 +1,41 @@
 #version 330 core
 
-// Vertex shader for transforming 2D positions and passing vertex color
+// Instanced vertex shader for label outlines (GL_LINES, 8 vertices per instance)
 
-// Vertex attributes:
-// location 0: 2D position (x, y)
-layout(location = 0) in vec2 aPos;
-// location 1: RGB color specified per-vertex
-layout(location = 1) in vec3 aColor;
+// Per-instance attributes:
+// location 0: label anchor (the labeled point, x, y)
+layout(location = 0) in vec2 aAnchor;
+// location 1: packed label = 16-bit log-scale size code | corner << 16 (threshold_codec.hpp)
+layout(location = 1) in uint aLabel;
 
 // Uniform: view/projection matrix combining orthographic projection and camera transform
 uniform mat4 u_view;
+// Uniforms: size decoding, size = exp(u_logMin + (code - 1) / 65534 * u_logRange)
+uniform float u_logMin;
+uniform float u_logRange;
 
-// Output to fragment shader: interpolated color
+// Output to fragment shader: outline color
 out vec3 vColor;
 
+// Unit square outline as 4 line segments
+const vec2 kOutline[8] = vec2[8](
+    vec2(0.0, 0.0), vec2(1.0, 0.0),
+    vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(1.0, 1.0), vec2(0.0, 1.0),
+    vec2(0.0, 1.0), vec2(0.0, 0.0)
+);
+
 void main() {
-    // Pass through the vertex color to the fragment shader
-    vColor = aColor;
+    uint code   = aLabel & 0xFFFFu;
+    uint corner = (aLabel >> 16) & 3u;
+
+    // Code 0 = no label: collapse the outline to a point
+    float s = (code == 0u) ? 0.0 : exp(u_logMin + float(code - 1u) / 65534.0 * u_logRange);
+
+    // Same corner convention as getAABB(): 0=TL, 1=TR, 2=BR, 3=BL
+    vec2 lo = vec2((corner == 1u || corner == 2u) ? aAnchor.x : aAnchor.x - s,
+                   (corner >= 2u)                 ? aAnchor.y : aAnchor.y - s);
 
-    // Transform the 2D position into clip space using the view matrix
-    // Expand to vec4 with z=0.0 and w=1.0
-    gl_Position = u_view * vec4(aPos, 0.0, 1.0);
-}
\ No newline at end of file
+    vColor = vec3(0.0);
+    gl_Position = u_view * vec4(lo + kOutline[gl_VertexID] * s, 0.0, 1.0);
+}
@@ -2,14 +2,17 @@
 
 // Vertex shader for rendering 2D points without per-vertex color
 
-// Vertex attribute: 2D position at location 0 (x, y)
+// Vertex attribute: 16-bit normalized position within the current tile (0..1 per axis)
 layout(location = 0) in vec2 aPos;
 
 // Uniform: view/projection matrix combining orthographic projection and camera transform
 uniform mat4 u_view;
+// Uniforms: tile transform, world = u_tileOrigin + aPos * u_tileScale
+uniform vec2 u_tileOrigin;
+uniform vec2 u_tileScale;
 
 void main() {
-    // Transform the 2D position into clip space
+    // Expand the quantized position, then transform into clip space
     // z is set to 0.0 and w to 1.0 for homogeneous coordinates
-    gl_Position = u_view * vec4(aPos, 0.0, 1.0);
-}
\ No newline at end of file
+    gl_Position = u_view * vec4(u_tileOrigin + aPos * u_tileScale, 0.0, 1.0);
+}
@@ -0,0 +1,249 @@
+// src/csv_reader.cpp
+#include "csv_reader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+// -------------------- helpers --------------------
+static inline void trim(const char*& b, const char*& e) {
+    while (b < e && std::isspace((unsigned char)*b)) ++b;
+    while (e > b && std::isspace((unsigned char)e[-1])) --e;
+}
+
+static std::string lower(std::string s) {
+    for (auto& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+static bool isIndexSpec(const std::string& s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c){ return std::isdigit(c); });
+}
+
+// One field starting at p: sets f to its contents (quotes excluded for a quoted field) and
+// returns the position of the delimiter that ends it (or end). Spaces before an opening
+// quote are skipped; text after a closing quote up to the delimiter is ignored.
+static const char* scanField(const char* p, const char* end, char delim, CsvField& f) {
+    const char* q = p;
+    while (q < end && *q != delim && (*q == ' ' || *q == '\t')) ++q;
+    if (q < end && *q == '"') {
+        const char* b = ++q;
+        while (q < end) {
+            if (*q == '"') {
+                if (q + 1 < end && q[1] == '"') { q += 2; continue; } // "" escape
+                break;
+            }
+            ++q;
+        }
+        f = {b, q};
+        while (q < end && *q != delim) ++q;
+        return q;
+    }
+    const char* b = p;
+    while (p < end && *p != delim) ++p;
+    f = {b, p};
+    return p;
+}
+
+// -------------------- line structure --------------------
+char detectCsvDelimiter(const std::string& line) {
+    static const char kCandidates[] = {',', ';', '\t', '|'};
+    int counts[4] = {0, 0, 0, 0};
+    bool quoted = false;
+    for (char c : line) {
+        if (c == '"') { quoted = !quoted; continue; } // "" toggles twice: no net change
+        if (quoted) continue;
+        for (int k = 0; k < 4; ++k) if (c == kCandidates[k]) ++counts[k];
+    }
+    int best = 0;
+    for (int k = 1; k < 4; ++k) if (counts[k] > counts[best]) best = k;
+    return kCandidates[best];
+}
+
+bool parseCsvDelimiter(const std::string& s, char& out) {
+    if (s == "tab" || s == "\\t") { out = '\t'; return true; }
+    if (s.size() != 1 || s[0] == '"' || s[0] == '\n' || s[0] == '\r') return false;
+    out = s[0];
+    return true;
+}
+
+std::vector<std::string> splitCsvLine(const std::string& line, char delimiter) {
+    std::vector<std::string> out;
+    const char* p = line.data();
+    const char* end = p + line.size();
+    while (true) {
+        CsvField f;
+        const char* stop = scanField(p, end, delimiter, f);
+        const char* fb = f.begin; const char* fe = f.end;
+        trim(fb, fe);
+        std::string field;
+        for (const char* c = fb; c < fe; ++c) {
+            field.push_back(*c);
+            if (*c == '"' && c + 1 < fe && c[1] == '"') ++c; // unescape ""
+        }
+        out.push_back(std::move(field));
+        if (stop >= end) break;
+        p = stop + 1;
+    }
+    return out;
+}
+
+bool isCsvHeader(const std::vector<std::string>& firstLine, const std::vector<std::string>& specs) {
+    for (const auto& spec : specs) {
+        if (spec.empty()) continue;
+        const size_t bar = spec.find('|');
+        const std::string index = bar == std::string::npos ? spec : spec.substr(bar + 1);
+        if (!isIndexSpec(index)) return true; // selected by name only: names live in a header
+        const size_t col = (size_t)std::atoi(index.c_str());
+        if (col >= firstLine.size() || firstLine[col].empty()) continue;
+        double v;
+        const std::string& h = firstLine[col];
+        if (!parseDoubleField(CsvField{h.data(), h.data() + h.size()}, v)) return true;
+    }
+    return false;
+}
+
+// -------------------- fields --------------------
+// strtof/strtod need a terminator; fields are short, copy to a stack buffer
+template <class T, class Conv>
+static bool parseNumberField(const CsvField& f, T& out, Conv conv) {
+    if (!f.begin) return false;
+    const char* b = f.begin; const char* e = f.end;
+    trim(b, e);
+    if (b == e) return false;
+    char buf[64];
+    const size_t n = (size_t)(e - b);
+    if (n >= sizeof(buf)) return false;
+    std::copy(b, e, buf);
+    buf[n] = '\0';
+    char* stop = nullptr;
+    const T v = conv(buf, &stop);
+    if (stop != buf + n) return false;
+    out = v;
+    return true;
+}
+
+bool parseFloatField(const CsvField& f, float& out) {
+    return parseNumberField(f, out, [](const char* s, char** e){ return std::strtof(s, e); });
+}
+
+bool parseDoubleField(const CsvField& f, double& out) {
+    return parseNumberField(f, out, [](const char* s, char** e){ return std::strtod(s, e); });
+}
+
+int resolveCsvColumn(const std::string& spec, const std::vector<std::string>& header) {
+    if (spec.empty()) return -1;
+    const size_t bar = spec.find('|');
+    if (bar != std::string::npos) // "name|index": name with a header, index without
+        return header.empty() ? resolveCsvColumn(spec.substr(bar + 1), header)
+                              : resolveCsvColumn(spec.substr(0, bar), header);
+    if (isIndexSpec(spec)) return std::atoi(spec.c_str());
+    const std::string want = lower(spec);
+    for (size_t i = 0; i < header.size(); ++i)
+        if (lower(header[i]) == want) return (int)i;
+    return -1;
+}
+
+int selectCsvFields(const std::string& line, const std::vector<int>& cols, std::vector<CsvField>& out,
+                    char delimiter) {
+    out.assign(cols.size(), CsvField{});
+    int maxCol = -1;
+    for (int c : cols) maxCol = std::max(maxCol, c);
+    if (maxCol < 0) return 0;
+
+    int found = 0;
+    const char* p = line.data();
+    const char* end = p + line.size();
+    // Walk field by field; keep a slice only when it is requested, stop after maxCol
+    for (int col = 0; col <= maxCol; ++col) {
+        CsvField f;
+        const char* stop = scanField(p, end, delimiter, f);
+        for (size_t k = 0; k < cols.size(); ++k) {
+            if (cols[k] == col) { out[k] = f; ++found; }
+        }
+        if (stop >= end) break;
+        p = stop + 1;
+    }
+    return found;
+}
+
+// -------------------- streaming --------------------
+bool forEachCsvRow(const std::string& path,
+                   const std::vector<std::string>& specs,
+                   const std::function<void(const std::vector<CsvField>&)>& row,
+                   std::string* error,
+                   const CsvOptions& opts) {
+    std::ifstream in(path);
+    if (!in) { if (error) *error = "Failed to open input: " + path; return false; }
+
+    std::string line;
+    std::vector<int> cols;
+    std::vector<CsvField> fields;
+    char delim = opts.delimiter;
+    bool first = true;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (first) {
+            first = false;
+            if (!delim) delim = detectCsvDelimiter(line);
+            std::vector<std::string> head = splitCsvLine(line, delim);
+            const bool isHeader = isCsvHeader(head, specs);
+            if (!isHeader) head.clear();
+            cols.clear();
+            for (const auto& s : specs) {
+                const int c = resolveCsvColumn(s, head);
+                if (!s.empty() && c < 0 && s.find('|') == std::string::npos) {
+                    if (error) *error = "Unknown column '" + s + "' in " + path;
+                    return false;
+                }
+                cols.push_back(c);
+            }
+            if (isHeader) continue;
+        }
+        selectCsvFields(line, cols, fields, delim);
+        row(fields);
+    }
+    return true;
+}
+
+bool readPointsCsvColumns(const std::string& path,
+                          const std::string& xCol, const std::string& yCol, const std::string& wCol,
+                          std::vector<std::array<float,2>>& pts,
+                          std::vector<float>& weights,
+                          std::string* error,
+                          const CsvOptions& opts) {
+    const bool wantWeight = !wCol.empty();
+    return forEachCsvRow(path, {xCol.empty() ? "0" : xCol, yCol.empty() ? "1" : yCol, wCol},
+        [&](const std::vector<CsvField>& f) {
+            float x, y;
+            if (!parseFloatField(f[0], x) || !parseFloatField(f[1], y)) return;
+            pts.push_back({x, y});
+            if (wantWeight) {
+                float w = 1.f;
+                if (!parseFloatField(f[2], w)) w = 1.f;
+                weights.push_back(w);
+            }
+        }, error, opts);
+}
+
+bool readPointsCsvColumns(const std::string& path,
+                          const std::string& xCol, const std::string& yCol, const std::string& wCol,
+                          std::vector<double>& xs, std::vector<double>& ys,
+                          std::vector<float>& weights,
+                          std::string* error,
+                          const CsvOptions& opts) {
+    const bool wantWeight = !wCol.empty();
+    return forEachCsvRow(path, {xCol.empty() ? "0" : xCol, yCol.empty() ? "1" : yCol, wCol},
+        [&](const std::vector<CsvField>& f) {
+            double x, y;
+            if (!parseDoubleField(f[0], x) || !parseDoubleField(f[1], y)) return;
+            xs.push_back(x); ys.push_back(y);
+            if (wantWeight) {
+                float w = 1.f;
+                if (!parseFloatField(f[2], w)) w = 1.f;
+                weights.push_back(w);
+            }
+        }, error, opts);
+}
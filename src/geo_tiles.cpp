@@ -0,0 +1,105 @@
+// src/geo_tiles.cpp
+#include "geo_tiles.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// -------------------- projection --------------------
+void projectLonLatToMercator(double* x, double* y, size_t n) {
+    constexpr double R = 6378137.0;                   // WGS84 semi-major axis
+    constexpr double kDeg = 3.14159265358979323846 / 180.0;
+    constexpr double kMaxLat = 85.05112878;
+    for (size_t i = 0; i < n; ++i) x[i] = R * kDeg * x[i];
+    for (size_t i = 0; i < n; ++i) {
+        const double lat = std::min(kMaxLat, std::max(-kMaxLat, y[i]));
+        const double s = std::sin(lat * kDeg);
+        y[i] = 0.5 * R * std::log((1.0 + s) / (1.0 - s)); // R * atanh(sin(lat))
+    }
+}
+
+// -------------------- local frame --------------------
+LocalFrame buildLocalFrame(const std::vector<double>& xs, const std::vector<double>& ys) {
+    LocalFrame f;
+    const size_t N = std::min(xs.size(), ys.size());
+    if (N == 0) return f;
+
+    double minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+    for (size_t i = 0; i < N; ++i) {
+        minX = std::min(minX, xs[i]); maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]); maxY = std::max(maxY, ys[i]);
+    }
+
+    // Origin at the extent center keeps offsets symmetric (smallest magnitude), unless the
+    // center is within 8 extents (16 half-extents) of zero
+    const double cx = 0.5 * (minX + maxX), cy = 0.5 * (minY + maxY);
+    const double half = 0.5 * std::max(maxX - minX, maxY - minY);
+    if (std::max(std::fabs(cx), std::fabs(cy)) > 16.0 * half) { f.originX = cx; f.originY = cy; }
+
+    f.offsets.resize(N);
+    for (size_t i = 0; i < N; ++i)
+        f.offsets[i] = {(float)(xs[i] - f.originX), (float)(ys[i] - f.originY)};
+    return f;
+}
+
+// -------------------- 16-bit tiles --------------------
+QuantizedTileLayout planQuantizedTiles(const std::vector<std::array<float,2>>& pts, int tilesPerAxis) {
+    QuantizedTileLayout out;
+    const size_t N = pts.size();
+    if (N == 0) return out;
+
+    float minX = pts[0][0], maxX = minX, minY = pts[0][1], maxY = minY;
+    for (const auto& p : pts) {
+        minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]);
+        minY = std::min(minY, p[1]); maxY = std::max(maxY, p[1]);
+    }
+    int T = tilesPerAxis;
+    if (T <= 0) T = (int)std::lround(std::sqrt((double)N / 16384.0));
+    T = std::max(1, std::min(T, 256));
+    const float span = std::max(maxX - minX, maxY - minY);
+    const float inv = span > 0.f ? (float)T / span : 0.f;
+
+    // Counting sort of point indices by tile key (4 bytes per point, no copy of the points)
+    auto keyOf = [&](const std::array<float,2>& p) {
+        const int tx = std::min(T - 1, (int)((p[0] - minX) * inv));
+        const int ty = std::min(T - 1, (int)((p[1] - minY) * inv));
+        return (uint32_t)(ty * T + tx);
+    };
+    std::vector<uint32_t> start((size_t)T * T + 1, 0);
+    for (const auto& p : pts) ++start[keyOf(p) + 1];
+    for (size_t k = 1; k < start.size(); ++k) start[k] += start[k - 1];
+
+    out.order.resize(N);
+    {
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < N; ++i) out.order[fill[keyOf(pts[i])]++] = (uint32_t)i;
+    }
+
+    for (size_t k = 0; k + 1 < start.size(); ++k) {
+        const uint32_t b = start[k], e = start[k + 1];
+        if (b == e) continue;
+        const auto& p0 = pts[out.order[b]];
+        float tx0 = p0[0], tx1 = tx0, ty0 = p0[1], ty1 = ty0;
+        for (uint32_t i = b; i < e; ++i) {
+            const auto& p = pts[out.order[i]];
+            tx0 = std::min(tx0, p[0]); tx1 = std::max(tx1, p[0]);
+            ty0 = std::min(ty0, p[1]); ty1 = std::max(ty1, p[1]);
+        }
+        QuantizedTile t;
+        t.originX = tx0; t.originY = ty0;
+        t.scaleX = tx1 - tx0; t.scaleY = ty1 - ty0;
+        t.begin = b; t.count = e - b;
+        out.tiles.push_back(t);
+    }
+    return out;
+}
+
+void quantizeTile(const std::vector<std::array<float,2>>& pts, const QuantizedTileLayout& layout,
+                  const QuantizedTile& t, std::array<uint16_t,2>* q) {
+    const float sx = t.scaleX > 0.f ? 65535.f / t.scaleX : 0.f;
+    const float sy = t.scaleY > 0.f ? 65535.f / t.scaleY : 0.f;
+    for (uint32_t k = 0; k < t.count; ++k) {
+        const auto& p = pts[layout.order[t.begin + k]];
+        q[k] = {(uint16_t)std::lround(std::min(65535.f, (p[0] - t.originX) * sx)),
+                (uint16_t)std::lround(std::min(65535.f, (p[1] - t.originY) * sy))};
+    }
+}
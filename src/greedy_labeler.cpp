@@ -1,5 +1,6 @@
 // src/greedy_labeler.cpp
 #include "greedy_labeler.hpp"
+#include "numa_topology.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -9,6 +10,8 @@
 #include <vector>
 #include <climits>
 #include <memory>  // ADD THIS
+#include <mutex>
+#include <thread>
 
 // -------------------- spatial hashing (move to top) --------------------
 struct CellKey { int x, y; };
@@ -82,6 +85,7 @@ generateLabelCandidates(const std::vector<std::array<float,2>>& pts, float baseS
 struct PointGrid {
     float cs;
     const std::vector<std::array<float,2>>& pts;
+    size_t count; // number of points indexed (detects a resized point set)
     std::unordered_map<CellKey, std::vector<int>, CellHash, CellEq> grid;
 
     // NEW: bounds of occupied cells
@@ -89,7 +93,7 @@ struct PointGrid {
     int minCy = INT_MAX, maxCy = INT_MIN;
 
     PointGrid(const std::vector<std::array<float,2>>& p, float cellSize)
-        : cs(cellSize), pts(p) {
+        : cs(cellSize), pts(p), count(p.size()) {
         grid.reserve(p.size() * 2);
         for (int i = 0; i < (int)p.size(); ++i) {
             const int cx = cellOf(p[i][0], cs), cy = cellOf(p[i][1], cs);
@@ -132,11 +136,17 @@ struct PointGrid {
     }
 };
 
-// NEW: grid-based orthant clearance (Chebyshev) used to choose corners.
-// Scans cells in increasing rings, only within the requested orthant.
+// NEW: grid-based orthant clearance (Chebyshev) used to choose corners: the distance
+// max(|dx|, |dy|) to the nearest point strictly inside the orthant, i.e. the largest label that
+// fits at that corner. Scans cells in increasing rings from the point's own cell, only within
+// the requested orthant (ring r includes the point's own row and column). Points of ring r are
+// more than (r-1) cells away, so the scan stops once r cells reach the best distance and the
+// result does not depend on the cell size. `reach` (optional) gets the last ring scanned, or -1
+// when the scan ran out of occupied cells instead of stopping on the clearance bound (its
+// result then depends on every point of the orthant).
 static float orthantClearanceGrid(const PointGrid& pg,
                                   int i, float xi, float yi,
-                                  int sx, int sy, float eps) {
+                                  int sx, int sy, float eps, int* reach = nullptr) {
     const int cx = cellOf(xi, pg.cs), cy = cellOf(yi, pg.cs);
     float best = std::numeric_limits<float>::infinity();
 
@@ -146,12 +156,13 @@ static float orthantClearanceGrid(const PointGrid& pg,
     auto step = [](int s){ return s > 0 ? 1 : -1; };
     const int stepx = step(sx), stepy = step(sy);
 
-    for (int r = 1; r <= maxR; ++r) {
+    if (reach) *reach = -1;
+    for (int r = 0; r <= maxR; ++r) {
         bool touched = false;
 
         // Edge where |a| == r (x-edge of the ring in this orthant)
         const int ax = (sx > 0) ? (cx + r) : (cx - r);
-        const int by0 = (sy > 0) ? (cy + 1) : (cy - 1);
+        const int by0 = cy;
         const int by1 = (sy > 0) ? (cy + r) : (cy - r);
         for (int by = by0; (sy > 0) ? (by <= by1) : (by >= by1); by += stepy) {
             if (!pg.withinBounds(ax, by)) continue;
@@ -161,16 +172,16 @@ static float orthantClearanceGrid(const PointGrid& pg,
             for (int j : it->second) if (j != i) {
                 float dx = pg.pts[j][0] - xi, dy = pg.pts[j][1] - yi;
                 if (dx * sx > eps && dy * sy > eps) {
-                    float cand = std::min(std::fabs(dx), std::fabs(dy));
+                    float cand = std::max(std::fabs(dx), std::fabs(dy));
                     if (cand < best) best = cand;
                 }
             }
         }
 
-        // Edge where |b| == r (y-edge of the ring in this orthant)
+        // Edge where |b| == r (y-edge of the ring in this orthant, corner cell done above)
         const int by = (sy > 0) ? (cy + r) : (cy - r);
-        const int ax0 = (sx > 0) ? (cx + 1) : (cx - 1);
-        const int ax1 = (sx > 0) ? (cx + r) : (cx - r);
+        const int ax0 = cx;
+        const int ax1 = (sx > 0) ? (cx + r - 1) : (cx - r + 1);
         for (int ax2 = ax0; (sx > 0) ? (ax2 <= ax1) : (ax2 >= ax1); ax2 += stepx) {
             if (!pg.withinBounds(ax2, by)) continue;
             touched = true;
@@ -179,14 +190,14 @@ static float orthantClearanceGrid(const PointGrid& pg,
             for (int j : it->second) if (j != i) {
                 float dx = pg.pts[j][0] - xi, dy = pg.pts[j][1] - yi;
                 if (dx * sx > eps && dy * sy > eps) {
-                    float cand = std::min(std::fabs(dx), std::fabs(dy));
+                    float cand = std::max(std::fabs(dx), std::fabs(dy));
                     if (cand < best) best = cand;
                 }
             }
         }
 
         // Stop if further rings cannot improve best
-        if (std::isfinite(best) && (r * pg.cs) >= (best - eps)) break;
+        if (std::isfinite(best) && r * pg.cs >= best) { if (reach) *reach = r; break; }
 
         // If this ring hit nothing and we already stepped beyond bounds in both axes, bail
         if (!touched) {
@@ -198,37 +209,237 @@ static float orthantClearanceGrid(const PointGrid& pg,
     return best;
 }
 
+// All-pairs orthant clearance (same metric as orthantClearanceGrid), for tiny inputs.
+static float orthantClearanceBrute(const std::vector<std::array<float,2>>& pts,
+                                   int i, int sx, int sy, float eps) {
+    const float xi = pts[i][0], yi = pts[i][1];
+    float best = std::numeric_limits<float>::infinity();
+    for (int j = 0; j < (int)pts.size(); ++j) if (j != i) {
+        float dx = pts[j][0] - xi, dy = pts[j][1] - yi;
+        if (dx * sx > eps && dy * sy > eps) {
+            float cand = std::max(std::fabs(dx), std::fabs(dy));
+            if (cand < best) best = cand;
+        }
+    }
+    return best;
+}
+
+// Run fn(begin, end) over [0, n) split into contiguous chunks on up to `threads` workers.
+template <class Fn>
+static void parallelRanges(int n, int threads, Fn fn) {
+    threads = std::max(1, std::min(threads, n / 1024)); // not worth a thread below ~1k items
+    if (threads <= 1) { fn(0, n); return; }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    const int chunk = (n + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        const int b = t * chunk, e = std::min(n, b + chunk);
+        if (b < e) workers.emplace_back(fn, b, e);
+    }
+    for (auto& w : workers) w.join();
+}
+
+// Corner with the largest orthant clearance (first unbounded orthant wins).
+template <class Clearance>
+static inline int bestClearanceCorner(int i, Clearance clearance) {
+    float clear[4] = {clearance(i, -1, -1), clearance(i, +1, -1),
+                      clearance(i, +1, +1), clearance(i, -1, +1)}; // TL, TR, BR, BL
+    int best = 0; float bestV = -1.f;
+    for (int c = 0; c < 4; ++c) {
+        float v = clear[c];
+        if (!std::isfinite(v)) { best = c; bestV = v; break; }
+        if (v > bestV) { best = c; bestV = v; }
+    }
+    return best;
+}
+
+// NUMA path: points are split into one x-slab per node (equal counts). Each node's workers are
+// pinned to it and scan a node-local replica, allocated and filled by a pinned thread (first
+// touch), so ring scans never read remote memory. A replica holds only the grid columns of its
+// slab plus kHaloCells columns on each side. A scan sees exactly what it would see on the full
+// grid when its rings stay inside those columns, or when no point beyond them lies in the rows
+// it scanned; the few other points are redone on one shared full grid afterwards, so the
+// corners always match the single-node path.
+static constexpr int kHaloCells = 4;
+
+struct NodeSlab {
+    int slabB = 0, slabE = 0;       // slab range in x order
+    int repB = 0, repE = 0;         // replica range in x order (slab + halo columns)
+    int colL = 0, colR = 0;         // complete columns of the replica
+    int leftRows[2] = {INT_MAX, INT_MIN};  // row range of the points left of the replica
+    int rightRows[2] = {INT_MAX, INT_MIN}; // row range of the points right of the replica
+};
+
+static void chooseCornersPerNumaNode(const std::vector<std::array<float,2>>& points,
+                                     const NumaTopology& topo, int threads, float cs, float eps,
+                                     std::vector<int>& fixedCorner, ParallelStats* stats) {
+    const int N = (int)points.size();
+    const int nodes = std::min(topo.nodeCount(), threads);
+
+    std::vector<int> order(N);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b){ return points[a][0] < points[b][0]; });
+    auto columnAt = [&](int k) { return cellOf(points[order[k]][0], cs); };
+    auto rowAt = [&](int k) { return cellOf(points[order[k]][1], cs); };
+
+    // Slabs, their halo columns and the rows occupied beyond them (one pass per node)
+    std::vector<NodeSlab> slabs(nodes);
+    for (int node = 0; node < nodes; ++node) {
+        NodeSlab& sl = slabs[node];
+        sl.slabB = (int)((int64_t)N * node / nodes);
+        sl.slabE = (int)((int64_t)N * (node + 1) / nodes);
+        if (sl.slabB >= sl.slabE) continue;
+        sl.colL = columnAt(sl.slabB) - kHaloCells;
+        sl.colR = columnAt(sl.slabE - 1) + kHaloCells;
+        sl.repB = sl.slabB; sl.repE = sl.slabE;
+        while (sl.repB > 0 && columnAt(sl.repB - 1) >= sl.colL) --sl.repB;
+        while (sl.repE < N && columnAt(sl.repE) <= sl.colR) ++sl.repE;
+        for (int k = 0; k < sl.repB; ++k) {
+            sl.leftRows[0] = std::min(sl.leftRows[0], rowAt(k)); sl.leftRows[1] = std::max(sl.leftRows[1], rowAt(k));
+        }
+        for (int k = sl.repE; k < N; ++k) {
+            sl.rightRows[0] = std::min(sl.rightRows[0], rowAt(k)); sl.rightRows[1] = std::max(sl.rightRows[1], rowAt(k));
+        }
+    }
+
+    std::mutex statsMutex;
+    ParallelStats local;
+    local.numaNodes = nodes;
+    std::vector<int> redo; // global indices to finish on the full grid
+
+    auto runNode = [&](int node) {
+        const NodeSlab& sl = slabs[node];
+        if (sl.slabB >= sl.slabE) return;
+        const bool pinned = pinCurrentThreadToNode(topo, node);
+        std::vector<std::array<float,2>> replica(sl.repE - sl.repB); // first touch on this node
+        for (int k = sl.repB; k < sl.repE; ++k) replica[k - sl.repB] = points[order[k]];
+        PointGrid pg(replica, cs);
+        const int nThreads = threads / nodes + (node < threads % nodes ? 1 : 0);
+
+        // Exact if no point beyond the replica on the scanned side can be in a scanned cell:
+        // columns past the halo were not reached, or none of their points sits in a scanned row.
+        auto exactScan = [&](int cx, int cy, int sx, int sy, int reach) {
+            if (reach >= 0 && (sx > 0 ? cx + reach <= sl.colR : cx - reach >= sl.colL)) return true;
+            const int* rows = sx > 0 ? sl.rightRows : sl.leftRows;
+            if (rows[0] > rows[1]) return true; // nothing beyond: that side is complete
+            const int lo = sy > 0 ? cy : (reach >= 0 ? cy - reach : INT_MIN);
+            const int hi = sy > 0 ? (reach >= 0 ? cy + reach : INT_MAX) : cy;
+            return rows[1] < lo || rows[0] > hi;
+        };
+
+        std::vector<int> pinnedFlags(nThreads, pinned ? 1 : 0);
+        std::vector<uint64_t> localCounts(nThreads, 0);
+        std::vector<std::vector<int>> misses(nThreads);
+        auto work = [&](int t, int b, int e) {
+            if (t > 0) pinnedFlags[t] = pinCurrentThreadToNode(topo, node) ? 1 : 0;
+            for (int k = b; k < e; ++k) {
+                const int li = k - sl.repB;
+                const int cx = cellOf(replica[li][0], cs), cy = cellOf(replica[li][1], cs);
+                bool exact = true;
+                fixedCorner[order[k]] = bestClearanceCorner(li, [&](int j, int sx, int sy){
+                    int reach = -1;
+                    const float v = orthantClearanceGrid(pg, j, replica[j][0], replica[j][1], sx, sy, eps, &reach);
+                    exact = exact && exactScan(cx, cy, sx, sy, reach);
+                    return v;
+                });
+                if (!exact) misses[t].push_back(order[k]);
+                // Sample where we run every 64 items (sched_getcpu is cheap but not free)
+                if (((k - b) & 63) == 0 && currentNumaNode(topo) == node)
+                    localCounts[t] += (uint64_t)std::min(64, e - k);
+            }
+        };
+        std::vector<std::thread> helpers;
+        const int chunk = (sl.slabE - sl.slabB + nThreads - 1) / std::max(1, nThreads);
+        for (int t = 1; t < nThreads; ++t) {
+            const int b = std::min(sl.slabE, sl.slabB + t * chunk), e = std::min(sl.slabE, b + chunk);
+            helpers.emplace_back(work, t, b, e);
+        }
+        work(0, sl.slabB, std::min(sl.slabE, sl.slabB + chunk));
+        for (auto& h : helpers) h.join();
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        local.threads += nThreads;
+        for (int t = 0; t < nThreads; ++t) {
+            local.pinnedThreads += pinnedFlags[t];
+            local.localItems += localCounts[t];
+            redo.insert(redo.end(), misses[t].begin(), misses[t].end());
+        }
+        local.items += (uint64_t)(sl.slabE - sl.slabB);
+        local.replicaBytes += replica.size() * sizeof(replica[0]) + pg.count * sizeof(int) +
+                              pg.grid.size() * (sizeof(CellKey) + sizeof(std::vector<int>));
+    };
+
+    // One leader thread per node (the caller's own affinity is never changed)
+    std::vector<std::thread> leaders;
+    for (int node = 0; node < nodes; ++node) leaders.emplace_back(runNode, node);
+    for (auto& l : leaders) l.join();
+
+    if (!redo.empty()) {
+        const PointGrid full(points, cs);
+        parallelRanges((int)redo.size(), threads, [&](int b, int e) {
+            for (int k = b; k < e; ++k) {
+                const int i = redo[k];
+                fixedCorner[i] = bestClearanceCorner(i, [&](int j, int sx, int sy){
+                    return orthantClearanceGrid(full, j, points[j][0], points[j][1], sx, sy, eps);
+                });
+            }
+        });
+    }
+
+    if (stats) {
+        stats->runs++;
+        stats->numaNodes = local.numaNodes;
+        stats->threads += local.threads;
+        stats->pinnedThreads += local.pinnedThreads;
+        stats->items += local.items;
+        stats->localItems += local.localItems;
+        stats->replicaBytes += local.replicaBytes;
+        stats->haloMisses += (uint64_t)redo.size();
+    }
+}
+
 // Replace chooseFixedCornersByConflicts to use orthantClearanceGrid.
 // This restores outward-facing behavior with grid-based complexity.
 static std::vector<int> chooseFixedCornersByConflicts(
     const std::vector<std::array<float,2>>& points,
-    float /*baseSize*/) {
+    const PlacementOptions& opts) {
 
     const int N = (int)points.size();
     std::vector<int> fixedCorner(N, 1); // TR default
     if (N == 0) return fixedCorner;
 
-    // Use point grid + orthant clearance (Chebyshev) without KD-tree dependence.
-    PointGrid pg(points, /*cellSize*/ 0.05f); // cellSize heuristic; original baseSize may be unavailable here.
+    const float cs = opts.cornerCellSize > 0.f ? opts.cornerCellSize : 0.05f;
     const float eps = 1e-6f;
 
+    // Multi-node machines: partition per NUMA node (falls through on single-node machines)
+    const int threads = std::max(1, std::min(opts.threads, N / 1024));
+    if (opts.numa && threads > 1 && opts.corners == CornerPolicy::ClearanceGrid) {
+        const NumaTopology& topo = opts.topology ? *opts.topology : numaTopology();
+        if (topo.nodeCount() > 1) {
+            chooseCornersPerNumaNode(points, topo, threads, cs, eps, fixedCorner, opts.stats);
+            return fixedCorner;
+        }
+    }
+
+    // Use point grid + orthant clearance (Chebyshev) without KD-tree dependence.
+    std::unique_ptr<PointGrid> pg;
+    if (opts.corners == CornerPolicy::ClearanceGrid) pg = std::make_unique<PointGrid>(points, cs);
+
     auto clearance = [&](int i, int sx, int sy){
-        return orthantClearanceGrid(pg, i, points[i][0], points[i][1], sx, sy, eps);
+        return pg ? orthantClearanceGrid(*pg, i, points[i][0], points[i][1], sx, sy, eps)
+                  : orthantClearanceBrute(points, i, sx, sy, eps);
     };
 
-    for (int i = 0; i < N; ++i) {
-        float cTL = clearance(i, -1, -1);
-        float cTR = clearance(i, +1, -1);
-        float cBR = clearance(i, +1, +1);
-        float cBL = clearance(i, -1, +1);
-        float clear[4] = {cTL, cTR, cBR, cBL};
-        int best = 0; float bestV = -1.f;
-        for (int c = 0; c < 4; ++c) {
-            float v = clear[c];
-            if (!std::isfinite(v)) { best = c; bestV = v; break; }
-            if (v > bestV) { best = c; bestV = v; }
-        }
-        fixedCorner[i] = best;
+    // Each point is independent: split the loop across workers (read-only grid).
+    parallelRanges(N, opts.threads, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) fixedCorner[i] = bestClearanceCorner(i, clearance);
+    });
+    if (opts.stats && threads > 1) {
+        opts.stats->runs++;
+        opts.stats->numaNodes = 1;
+        opts.stats->threads += threads;
+        opts.stats->items += (uint64_t)N;
+        opts.stats->localItems += (uint64_t)N; // one node: all memory is local
     }
     return fixedCorner;
 }
@@ -239,10 +450,11 @@ static inline float rectGapToAABB(const Rect& a, const Rect& b) {
 }
 
 // -------------------- Quadtree for rectangles --------------------
+struct QuadItem { Rect r; int id; };
 struct QuadNode {
     Rect bounds;
     int depth;
-    std::vector<Rect> items;           // rects that don't fit entirely in a child
+    std::vector<QuadItem> items;       // rects that don't fit entirely in a child
     std::unique_ptr<QuadNode> child[4];
     QuadNode(const Rect& b, int d) : bounds(b), depth(d) {}
 };
@@ -286,42 +498,47 @@ struct QuadRectIndex {
         for (int q=0;q<4;++q)
             n->child[q] = std::make_unique<QuadNode>(childBounds(n->bounds,q), n->depth+1);
         // reinsert items that fit fully in a child
-        std::vector<Rect> keep;
+        std::vector<QuadItem> keep;
         keep.reserve(n->items.size());
-        for (const Rect& r : n->items) {
-            int c = whichChild(n->bounds, r);
-            if (c >= 0) n->child[c]->items.push_back(r);
-            else keep.push_back(r);
+        for (const QuadItem& it : n->items) {
+            int c = whichChild(n->bounds, it.r);
+            if (c >= 0) n->child[c]->items.push_back(it);
+            else keep.push_back(it);
         }
         n->items.swap(keep);
     }
 
-    void insert(const Rect& r) { insertRec(root.get(), r); }
+    void insert(const Rect& r, int id = -1) { insertRec(root.get(), {r, id}); }
 
-    void insertRec(QuadNode* n, const Rect& r) {
+    void insertRec(QuadNode* n, const QuadItem& it) {
         if (n->depth < maxDepth) {
-            int c = whichChild(n->bounds, r);
+            int c = whichChild(n->bounds, it.r);
             if (c >= 0) {
                 if (!n->child[0]) split(n);
-                insertRec(n->child[c].get(), r);
+                insertRec(n->child[c].get(), it);
                 return;
             }
         }
-        n->items.push_back(r);
+        n->items.push_back(it);
         if ((int)n->items.size() > cap && n->depth < maxDepth) {
             split(n);
         }
     }
 
-    bool overlapsAny(const Rect& r) const { return overlapsAnyRec(root.get(), r); }
+    bool overlapsAny(const Rect& r) const { return overlapsAnyIf(r, [](int){ return true; }); }
 
-    bool overlapsAnyRec(const QuadNode* n, const Rect& r) const {
+    // Any stored rect overlapping r whose id passes hit(id)
+    template <class Hit>
+    bool overlapsAnyIf(const Rect& r, Hit hit) const { return overlapsAnyRec(root.get(), r, hit); }
+
+    template <class Hit>
+    bool overlapsAnyRec(const QuadNode* n, const Rect& r, Hit& hit) const {
         if (!overlapsStrict(n->bounds, r) && rectGapToAABB(n->bounds, r) > 0.f) return false;
-        for (const Rect& x : n->items)
-            if (overlapsStrict(x, r)) return true;
+        for (const QuadItem& x : n->items)
+            if (overlapsStrict(x.r, r) && hit(x.id)) return true;
         if (!n->child[0]) return false;
         for (int q=0;q<4;++q)
-            if (overlapsAnyRec(n->child[q].get(), r)) return true;
+            if (overlapsAnyRec(n->child[q].get(), r, hit)) return true;
         return false;
     }
 
@@ -335,8 +552,8 @@ struct QuadRectIndex {
         // prune by bbox lower bound
         float lb = rectGapToAABB(n->bounds, r);
         if (!(lb < best)) return;
-        for (const Rect& x : n->items) {
-            float g = rectGap(x, r);
+        for (const QuadItem& x : n->items) {
+            float g = rectGap(x.r, r);
             if (g < best) best = g;
             if (best == 0.f) return;
         }
@@ -382,7 +599,11 @@ struct RectGrid {
                 grid[{cx, cy}].push_back(id);
     }
 
-    bool overlapsAny(const Rect& r) const {
+    bool overlapsAny(const Rect& r) const { return overlapsAnyIf(r, [](int){ return true; }); }
+
+    // Any stored rect overlapping r whose id (insertion order) passes hit(id)
+    template <class Hit>
+    bool overlapsAnyIf(const Rect& r, Hit hit) const {
         const int x0 = cellOf(r.xmin, cs), x1 = cellOf(r.xmax, cs);
         const int y0 = cellOf(r.ymin, cs), y1 = cellOf(r.ymax, cs);
         for (int cy = y0; cy <= y1; ++cy)
@@ -390,7 +611,7 @@ struct RectGrid {
                 auto it = grid.find({cx, cy});
                 if (it == grid.end()) continue;
                 for (int id : it->second)
-                    if (overlapsStrict(r, rects[id])) return true;
+                    if (overlapsStrict(r, rects[id]) && hit(id)) return true;
             }
         return false;
     }
@@ -409,6 +630,46 @@ struct RectGrid {
         return best;
     }
 };
+
+// Placed-label index selected by PlacementOptions::rectIndex.
+struct PlacedRectIndex {
+    RectIndexKind kind;
+    RectGrid grid;
+    std::unique_ptr<QuadRectIndex> quad;
+    std::vector<Rect> list;
+
+    PlacedRectIndex(RectIndexKind k, float cellSize, const Rect& world, size_t expectedRects)
+        : kind(k), grid(cellSize, k == RectIndexKind::Grid ? expectedRects : 0) {
+        if (kind == RectIndexKind::Quadtree) quad = std::make_unique<QuadRectIndex>(world);
+        else if (kind == RectIndexKind::Linear) list.reserve(expectedRects);
+    }
+
+    // Ids are insertion order (0, 1, ...) for every kind
+    void insert(const Rect& r) {
+        switch (kind) {
+            case RectIndexKind::Grid:     grid.insert(r); break;
+            case RectIndexKind::Quadtree: quad->insert(r, quadIds++); break;
+            case RectIndexKind::Linear:   list.push_back(r); break;
+        }
+    }
+
+    bool overlapsAny(const Rect& r) const { return overlapsAnyIf(r, [](int){ return true; }); }
+
+    template <class Hit>
+    bool overlapsAnyIf(const Rect& r, Hit hit) const {
+        switch (kind) {
+            case RectIndexKind::Grid:     return grid.overlapsAnyIf(r, hit);
+            case RectIndexKind::Quadtree: return quad->overlapsAnyIf(r, hit);
+            case RectIndexKind::Linear:
+                for (int id = 0; id < (int)list.size(); ++id)
+                    if (overlapsStrict(list[id], r) && hit(id)) return true;
+                return false;
+        }
+        return false;
+    }
+
+    int quadIds = 0; // ids handed to the quadtree so far
+};
 // ------------------------------------------------------------
 
 // Greedy with grids (O(n log n) due to one sort)
@@ -486,13 +747,113 @@ static std::vector<Rect> greedyPlaceInternal(
 }
 } // namespace
 
+// Cell of the point and placed-label grids for labels of size s: the power of two in (s, 2s].
+// A descending sweep keeps its grids for a halving of the size, and the cell (so the density
+// order computed on it) depends on s alone, never on the sizes placed before.
+static float sweepCell(float s) {
+    int e = 0;
+    std::frexp(s, &e);
+    return std::ldexp(1.0f, e);
+}
+
+// Label square of point pid at size s (same float ops as getAABB on its candidate)
+static inline Rect labelAABB(const std::vector<std::array<float,2>>& points, int pid, int corner, float s) {
+    return getAABB({{points[pid][0], points[pid][1]}, s, corner, 1.0f, false});
+}
+
+// Zoom-out indices kept in MonotoneState::placement while the point grid stays the same.
+// Active labels are stored at their insertion size: a label only shrinks towards its anchor
+// as the size decreases, so the stored square bounds it at every smaller size and serves as
+// a broad phase for the exact test at the current size.
+struct PlacementCache {
+    PlacedRectIndex rects;     // active labels, id = insertion order
+    std::vector<int> owner;    // point of each stored rect
+    std::vector<int> pending;  // inactive points, densest first (ties: lower index)
+    float minInsertSize;       // valid for sizes <= the smallest insertion size
+    RectIndexKind kind;
+
+    PlacementCache(RectIndexKind k, float cell, const Rect& world, size_t n, float insertSize)
+        : rects(k, cell, world, n), minInsertSize(insertSize), kind(k) {}
+
+    void insert(const Rect& r, int pid, float size) {
+        rects.insert(r);
+        owner.push_back(pid);
+        minInsertSize = std::min(minInsertSize, size);
+    }
+};
+
+// Points sorted by 3x3 cell density on pg (densest first, ties by index)
+static void sortByDensity(const PointGrid& pg, std::vector<int>& pids) {
+    std::vector<int> dens(pg.count, 0);
+    for (int pid : pids) dens[pid] = pg.localCount(pg.pts[pid][0], pg.pts[pid][1]);
+    std::sort(pids.begin(), pids.end(), [&](int a, int b){
+        return dens[a] != dens[b] ? dens[a] > dens[b] : a < b;
+    });
+}
+
+// Point grid on sweepCell(baseSize), reused while the cell stays the same. A rebuilt grid drops
+// the zoom-out cache built on it. Callers reset pointIndex (or the state) when the point
+// contents change; the vector address and size are only a cheap guard.
+static const PointGrid& pointGridFor(const std::vector<std::array<float,2>>& points, float baseSize,
+                                     MonotoneState& state) {
+    const float cell = sweepCell(baseSize);
+    const PointGrid* cached = state.pointIndex.get();
+    if (!cached || &cached->pts != &points || cached->count != points.size() || cached->cs != cell) {
+        state.pointIndex = std::make_shared<PointGrid>(points, cell);
+        state.placement.reset();
+    }
+    return *state.pointIndex;
+}
+
+// Zoom-out cache usable at baseSize, rebuilt when missing, shared with a copied state, built
+// for another index kind or stored at sizes below baseSize. A rebuild stores the active labels
+// at insertSize (>= baseSize) and orders the inactive points by density.
+static PlacementCache& zoomOutCache(const std::vector<std::array<float,2>>& points, const PointGrid& pg,
+                                    float baseSize, float insertSize, MonotoneState& state,
+                                    const PlacementOptions& opts) {
+    PlacementCache* pc = state.placement.get();
+    if (pc && state.placement.use_count() == 1 && pc->kind == opts.rectIndex && baseSize <= pc->minInsertSize)
+        return *pc;
+
+    const int N = (int)points.size();
+    // Quadtree root = occupied point cells padded by one label size
+    const Rect world{ pg.minCx * pg.cs - insertSize, pg.minCy * pg.cs - insertSize,
+                      (pg.maxCx + 1) * pg.cs + insertSize, (pg.maxCy + 1) * pg.cs + insertSize };
+    auto fresh = std::make_shared<PlacementCache>(opts.rectIndex, pg.cs, world, points.size(), insertSize);
+    std::vector<unsigned char> active(N, 0);
+    for (int idx : state.active) {
+        const int pid = ownerOf(idx, 4);
+        if (pid < 0 || pid >= N || active[pid]) continue;
+        active[pid] = 1;
+        fresh->insert(labelAABB(points, pid, state.fixedCorner[pid], insertSize), pid, insertSize);
+    }
+    fresh->pending.reserve(N);
+    for (int pid = 0; pid < N; ++pid) if (!active[pid]) fresh->pending.push_back(pid);
+    sortByDensity(pg, fresh->pending);
+    state.placement = std::move(fresh);
+    return *state.placement;
+}
+
+// Exact zoom-out feasibility of point pid's label r at size s: no other point inside, no
+// overlap with an active label at size s (stored squares only pre-filter).
+static bool zoomOutFeasible(const std::vector<std::array<float,2>>& points, const PointGrid& pg,
+                            const PlacementCache& pc, const std::vector<int>& fixedCorner,
+                            const Rect& r, int pid, float s) {
+    if (pg.anyInside(r, pid)) return false;
+    return !pc.rects.overlapsAnyIf(r, [&](int id) {
+        const int q = pc.owner[id];
+        return overlapsStrict(r, labelAABB(points, q, fixedCorner[q], s));
+    });
+}
+
 // Monotone greedy: on zoom-in keep only a feasible subset of the previous labels;
-// on zoom-out recompute greedily to add more.
+// on zoom-out keep all of them and add new ones greedily.
 std::vector<Rect>
 greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
                     const std::vector<std::array<float,2>>& points,
                     float baseSize,
-                    MonotoneState* state) { // state is now a pointer
+                    MonotoneState* state, // state is now a pointer
+                    const PlacementOptions& opts) {
     
     for (auto& c : candidates) { c.size = baseSize; c.valid = false; }
     
@@ -506,7 +867,7 @@ greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
 
     // 1) Determine fixed corners
     if ((int)state->fixedCorner.size() != N) {
-        state->fixedCorner = chooseFixedCornersByConflicts(points, baseSize);
+        state->fixedCorner = chooseFixedCornersByConflicts(points, opts);
     }
 
     // 2) Set corners on all candidates
@@ -523,9 +884,7 @@ greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
     const bool havePrev = state->lastBase >= 0.f;
     const bool zoomingOut = !havePrev || baseSize < state->lastBase;
 
-    // Build fast indices for this pass
-    PointGrid pg(points, baseSize);
-    RectGrid rg(baseSize, points.size());
+    const PointGrid& pg = pointGridFor(points, baseSize, *state);
     auto rectHasOtherPoint = [&](const Rect& R, int skip)->bool {
         return pg.anyInside(R, skip);
     };
@@ -533,59 +892,61 @@ greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
     std::vector<int> next_active; // Temporary vector for the new active set
     next_active.reserve(N);
 
-    // 4) Keep feasible previous labels
-    std::vector<int> keep;
-    keep.reserve(state->active.size());
-    for (int idx : state->active) {
-        int pid = ownerOf(idx, perPoint);
-        if (pid >= 0 && pid < N) {
-            keep.push_back(pid * perPoint + state->fixedCorner[pid]);
-        }
-    }
-    std::sort(keep.begin(), keep.end());
-    keep.erase(std::unique(keep.begin(), keep.end()), keep.end());
-
-    std::vector<unsigned char> isActiveNow(N, 0);
-    for (int idx : keep) {
-        const int pid = ownerOf(idx, perPoint);
-        const Rect r = getAABB(candidates[idx]);
-        if (rectHasOtherPoint(r, pid) || rg.overlapsAny(r)) continue;
-        
-        candidates[idx].valid = true;
-        rg.insert(r);
-        placed.push_back(r);
-        next_active.push_back(idx);
-        isActiveNow[pid] = 1;
-        state->usedOnce[pid] = 1;
-    }
-
-    // 5) On zoom-out: add new labels
     if (zoomingOut) {
-        std::vector<int> order;
-        order.reserve(N);
-        for (int pid = 0; pid < N; ++pid) {
-            if (!isActiveNow[pid]) order.push_back(pid);
-        }
-        
-        // --- FIX: Cache density before sorting ---
-        std::vector<int> dens(N);
-        for (int pid = 0; pid < N; ++pid) {
-            dens[pid] = pg.localCount(points[pid][0], points[pid][1]);
+        // 4) Zoom-out: every active label shrinks towards its anchor and stays feasible. The
+        // cached index and density order carry over from the previous step; only the new
+        // activations are inserted.
+        PlacementCache& pc = zoomOutCache(points, pg, baseSize, baseSize, *state, opts);
+        for (int idx : state->active) {
+            const int pid = ownerOf(idx, perPoint);
+            const int k = pid * perPoint + state->fixedCorner[pid];
+            candidates[k].valid = true;
+            placed.push_back(getAABB(candidates[k]));
+            next_active.push_back(k);
         }
-        std::sort(order.begin(), order.end(), [&](int a, int b){
-            return dens[a] > dens[b];
-        });
-        // --- END FIX ---
-
-        for (int pid : order) {
+        // 5) Add new labels, densest points first
+        size_t keepPending = 0;
+        for (int pid : pc.pending) {
             const int k = pid * perPoint + state->fixedCorner[pid];
             const Rect r = getAABB(candidates[k]);
+            if (!zoomOutFeasible(points, pg, pc, state->fixedCorner, r, pid, baseSize)) {
+                pc.pending[keepPending++] = pid;
+                continue;
+            }
+            candidates[k].valid = true;
+            pc.insert(r, pid, baseSize);
+            placed.push_back(r);
+            next_active.push_back(k);
+            state->usedOnce[pid] = 1;
+        }
+        pc.pending.resize(keepPending);
+    } else {
+        // 4) Zoom-in: keep the previous labels that are still feasible (fresh index at this size)
+        state->placement.reset();
+        const Rect world{ pg.minCx * pg.cs - baseSize, pg.minCy * pg.cs - baseSize,
+                          (pg.maxCx + 1) * pg.cs + baseSize, (pg.maxCy + 1) * pg.cs + baseSize };
+        PlacedRectIndex rg(opts.rectIndex, pg.cs, world, points.size());
+
+        std::vector<int> keep;
+        keep.reserve(state->active.size());
+        for (int idx : state->active) {
+            int pid = ownerOf(idx, perPoint);
+            if (pid >= 0 && pid < N) {
+                keep.push_back(pid * perPoint + state->fixedCorner[pid]);
+            }
+        }
+        std::sort(keep.begin(), keep.end());
+        keep.erase(std::unique(keep.begin(), keep.end()), keep.end());
+
+        for (int idx : keep) {
+            const int pid = ownerOf(idx, perPoint);
+            const Rect r = getAABB(candidates[idx]);
             if (rectHasOtherPoint(r, pid) || rg.overlapsAny(r)) continue;
 
-            candidates[k].valid = true;
+            candidates[idx].valid = true;
             rg.insert(r);
             placed.push_back(r);
-            next_active.push_back(k);
+            next_active.push_back(idx);
             state->usedOnce[pid] = 1;
         }
     }
@@ -596,6 +957,22 @@ greedyPlaceMonotone(std::vector<LabelCandidate>& candidates,
     return placed;
 }
 
+bool monotoneZoomOutAddsLabels(const std::vector<std::array<float,2>>& points, float baseSize,
+                               MonotoneState* state, const PlacementOptions& opts) {
+    const int N = (int)points.size();
+    if (N == 0 || (int)state->fixedCorner.size() != N || (int)state->usedOnce.size() != N ||
+        !(state->lastBase >= 0.f && baseSize < state->lastBase))
+        return true; // not a zoom-out of a placed state: let the caller place it
+    const PointGrid& pg = pointGridFor(points, baseSize, *state);
+    // Stored at the current size, so the walk from lastBase down to baseSize can reuse it
+    const PlacementCache& pc = zoomOutCache(points, pg, baseSize, state->lastBase, *state, opts);
+    for (int pid : pc.pending) {
+        const Rect r = labelAABB(points, pid, state->fixedCorner[pid], baseSize);
+        if (zoomOutFeasible(points, pg, pc, state->fixedCorner, r, pid, baseSize)) return true;
+    }
+    return false;
+}
+
 // Keep the internal helper in the anonymous namespace above untouched.
 
 // Exported shim to satisfy old call sites and enforce monotone + usedOnce.
@@ -603,6 +980,7 @@ std::vector<Rect>
 greedyPlaceOneLabelPerPoint(std::vector<LabelCandidate>& candidates,
                             const std::vector<std::array<float,2>>& points) {
     static MonotoneState s; // The single, persistent state object
+    s.pointIndex.reset();   // callers may swap the point set between calls
     const float baseSize = candidates.empty() ? 0.02f : candidates[0].size;
     return greedyPlaceMonotone(candidates, points, baseSize, &s);
 }
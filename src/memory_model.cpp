@@ -0,0 +1,189 @@
+// src/memory_model.cpp
+#include "memory_model.hpp"
+#include "greedy_labeler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <vector>
+
+// -------------------- per-point constants --------------------
+// Hash grids (unordered_map<CellKey, vector<int>>): one node (next ptr, cached hash, key,
+// vector header: 48 bytes, a 64-byte malloc block) plus the vector's smallest heap block.
+static constexpr size_t kHashNodeBytes = 64 + 32;
+static constexpr size_t kBucketBytes   = sizeof(void*);
+// Worker thread: touched stack pages + its malloc arena's first heap pages
+static constexpr size_t kThreadBytes   = size_t(256) << 10;
+// Uncalibrated runs measured 0.97..1.27 x the model; stay above that until samples exist
+static constexpr double kColdStartRatio = 1.5;
+
+MemoryModel memoryModelFor(const std::string& engine, int threads, int numaNodes, bool weighted) {
+    MemoryModel m;
+    threads = std::max(1, threads);
+    m.baseBytes = (size_t(4) << 20) + (size_t)(threads - 1) * kThreadBytes;
+    // xs, ys (double) + points (float2) + frame order (uint32, freed after labeling starts)
+    m.inputPerPoint = 2 * sizeof(double) + sizeof(std::array<float,2>) + sizeof(uint32_t) +
+                      (weighted ? sizeof(float) : 0);
+    // generateLabelCandidates() per probe + the output candidates built before writing
+    m.candidatePerPoint = 2 * 4 * sizeof(LabelCandidate);
+    // Point grid cached in the probe state (~1 point per cell at small sizes, 2 buckets per
+    // point) + rect grid (~2 cells per label, 4 buckets per label) + the placed Rect itself
+    m.gridPerPoint = (kHashNodeBytes + 2 * kBucketBytes) +
+                     (2 * kHashNodeBytes + 4 * kBucketBytes) + sizeof(Rect);
+    // search: size/corner result, lo/hi interval, alive + chosen per probe
+    const size_t search = 2 * sizeof(float) + 2 * sizeof(int) + sizeof(unsigned char) + 2 * sizeof(int);
+    // monotone: state (active, fixedCorner, usedOnce), copy probed ahead of each fine walk,
+    // first-activation size/corner
+    const size_t monotone = 2 * (2 * sizeof(int) + sizeof(unsigned char) + 4 * sizeof(int)) +
+                            sizeof(float) + sizeof(int);
+    m.enginePerPoint = engine == "search" ? search
+                     : engine == "monotone" ? monotone
+                     : std::max(search, monotone);
+    // NUMA split: x order + the node replicas (slabs + a few halo columns: about one copy of the
+    // points and their grid in total; the halo-miss grid is built after the replicas are freed)
+    m.parallelPerPoint = threads > 1 && numaNodes > 1
+        ? sizeof(int) + sizeof(std::array<float,2>) + sizeof(int) + kHashNodeBytes + 2 * kBucketBytes
+        : 0;
+    return m;
+}
+
+uint64_t estimatePeakBytes(size_t points, const std::string& engine, int threads, int numaNodes, bool weighted) {
+    const MemoryModel m = memoryModelFor(engine, threads, numaNodes, weighted);
+    return (uint64_t)m.baseBytes + (uint64_t)points * m.perPoint();
+}
+
+// -------------------- batch admission --------------------
+long nextBatchJob(const std::vector<uint64_t>& pending, uint64_t inUse, size_t running, int maxJobs,
+                  uint64_t memLimit) {
+    if (pending.empty() || running >= (size_t)std::max(1, maxJobs)) return -1;
+    for (size_t k = 0; k < pending.size(); ++k)
+        if (inUse + pending[k] <= memLimit) return (long)k;
+    return running == 0 ? 0 : -1;
+}
+
+// -------------------- row counts --------------------
+// Non-empty lines (blank and "\r"-only lines are skipped by csv_reader as well)
+struct LineCounter {
+    size_t lines = 0;
+    size_t len = 0;  // length of the current line so far
+    char   last = 0; // its last character
+    void feed(const char* p, size_t n) {
+        const char* end = p + n;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', (size_t)(end - p)));
+            const char* stop = nl ? nl : end;
+            if (stop > p) { len += (size_t)(stop - p); last = stop[-1]; }
+            if (!nl) break;
+            if (len > 1 || (len == 1 && last != '\r')) ++lines;
+            len = 0;
+            p = nl + 1;
+        }
+    }
+    size_t finish() { feed("\n", 1); return lines; } // unterminated last row
+};
+
+// First non-empty line, read the way csv_reader sees it; true if it is a header for `specs`.
+// `bytes` gets the bytes up to and including that line's newline.
+static bool csvHasHeader(std::FILE* f, const std::vector<std::string>& specs, const CsvOptions& opts,
+                         size_t& bytes) {
+    std::string line;
+    bytes = 0;
+    int c;
+    while ((c = std::fgetc(f)) != EOF) {
+        ++bytes;
+        if (c == '\n') {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) break;
+            continue;
+        }
+        line.push_back((char)c);
+    }
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty()) return false;
+    const char delim = opts.delimiter ? opts.delimiter : detectCsvDelimiter(line);
+    return isCsvHeader(splitCsvLine(line, delim), specs);
+}
+
+size_t countCsvRows(const std::string& path, const std::vector<std::string>& specs, const CsvOptions& opts) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    size_t headerBytes = 0;
+    const bool header = csvHasHeader(f, specs, opts, headerBytes);
+    std::rewind(f);
+    std::vector<char> buf(1 << 16);
+    LineCounter lc;
+    size_t n = 0;
+    while ((n = std::fread(buf.data(), 1, buf.size(), f)) > 0) lc.feed(buf.data(), n);
+    std::fclose(f);
+    const size_t lines = lc.finish();
+    return header && lines > 0 ? lines - 1 : lines;
+}
+
+CsvRowEstimate estimateCsvRows(const std::string& path, const std::vector<std::string>& specs,
+                               const CsvOptions& opts, size_t sampleBytes) {
+    CsvRowEstimate est;
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return est;
+    size_t headerBytes = 0;
+    const bool header = csvHasHeader(f, specs, opts, headerBytes);
+    if (!header) { std::rewind(f); headerBytes = 0; }
+    std::vector<char> buf(std::max<size_t>(sampleBytes, 1));
+    const size_t n = std::fread(buf.data(), 1, buf.size(), f);
+    const bool whole = std::fgetc(f) == EOF;
+    std::fclose(f);
+
+    LineCounter lc;
+    if (whole) {
+        lc.feed(buf.data(), n);
+        est.rows = lc.finish();
+        est.exact = true;
+        return est;
+    }
+    // Complete lines of the sample only, scaled by the remaining file size
+    size_t used = n;
+    while (used > 0 && buf[used - 1] != '\n') --used;
+    lc.feed(buf.data(), used);
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    const uint64_t fileBytes = (uint64_t)std::max<std::streamoff>(0, (std::streamoff)in.tellg());
+    if (used == 0 || lc.lines == 0) { est.rows = (size_t)(fileBytes / std::max<size_t>(n, 1)); return est; }
+    est.rows = (size_t)((double)lc.lines * (double)(fileBytes - headerBytes) / (double)used + 0.5);
+    return est;
+}
+
+// -------------------- calibration --------------------
+MemoryCalibration loadMemoryCalibration(const std::string& path, const std::string& engine, int threads) {
+    MemoryCalibration cal;
+    cal.ratio = kColdStartRatio;
+    std::ifstream in(path);
+    if (!in) return cal;
+    std::deque<double> recent;
+    std::string line;
+    while (std::getline(in, line)) {
+        unsigned long long pts = 0, est = 0, act = 0;
+        char eng[32] = {0};
+        int thr = 0;
+        if (std::sscanf(line.c_str(), "%llu,%llu,%llu,%31[^,],%d", &pts, &est, &act, eng, &thr) != 5 || est == 0)
+            continue;
+        if (engine != eng || threads != thr) continue;
+        recent.push_back((double)act / (double)est);
+        if (recent.size() > 64) recent.pop_front();
+    }
+    if (recent.empty()) return cal;
+    cal.ratio = 1.1 * *std::max_element(recent.begin(), recent.end());
+    cal.samples = (int)recent.size();
+    return cal;
+}
+
+bool appendMemoryCalibration(const std::string& path, size_t points,
+                             uint64_t estimatedBytes, uint64_t peakRssBytes,
+                             const std::string& engine, int threads) {
+    const bool fresh = !std::ifstream(path).good();
+    std::ofstream out(path, std::ios::app);
+    if (!out) return false;
+    if (fresh) out << "points,estimated_bytes,peak_rss_bytes,engine,threads\n";
+    out << points << "," << estimatedBytes << "," << peakRssBytes << "," << engine << "," << threads << "\n";
+    return (bool)out;
+}
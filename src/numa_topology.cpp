@@ -0,0 +1,89 @@
+// src/numa_topology.cpp
+#include "numa_topology.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+
+// "0-3,8-11" -> {0,1,2,3,8,9,10,11}
+static std::vector<int> parseCpuList(const std::string& s) {
+    std::vector<int> cpus;
+    size_t i = 0;
+    while (i < s.size()) {
+        size_t j = s.find(',', i);
+        if (j == std::string::npos) j = s.size();
+        const std::string part = s.substr(i, j - i);
+        const size_t dash = part.find('-');
+        if (!part.empty() && part[0] >= '0' && part[0] <= '9') {
+            const int a = std::atoi(part.c_str());
+            const int b = dash == std::string::npos ? a : std::atoi(part.c_str() + dash + 1);
+            for (int c = a; c <= b; ++c) cpus.push_back(c);
+        }
+        i = j + 1;
+    }
+    return cpus;
+}
+
+NumaTopology loadNumaTopology(const std::string& sysRoot) {
+    NumaTopology topo;
+    DIR* dir = opendir(sysRoot.c_str());
+    if (!dir) return topo;
+    std::vector<int> ids;
+    while (dirent* e = readdir(dir)) {
+        const std::string name = e->d_name;
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), [](char c){ return c >= '0' && c <= '9'; }))
+            ids.push_back(std::atoi(name.c_str() + 4));
+    }
+    closedir(dir);
+    std::sort(ids.begin(), ids.end());
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int id : ids) {
+        std::ifstream in(sysRoot + "/node" + std::to_string(id) + "/cpulist");
+        std::string line;
+        if (!in || !std::getline(in, line)) continue;
+        std::vector<int> cpus;
+        for (int c : parseCpuList(line))
+            if (c < CPU_SETSIZE && (!haveMask || CPU_ISSET(c, &allowed))) cpus.push_back(c);
+        if (cpus.empty()) continue; // memory-only node or outside our cpuset
+        topo.nodeIds.push_back(id);
+        topo.nodeCpus.push_back(std::move(cpus));
+    }
+    return topo;
+}
+
+bool pinCurrentThreadToNode(const NumaTopology& topo, int node) {
+    if (node < 0 || node >= topo.nodeCount()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : topo.nodeCpus[node]) CPU_SET(c, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0; // 0 = calling thread
+}
+
+int currentNumaNode(const NumaTopology& topo) {
+    const int cpu = sched_getcpu();
+    if (cpu < 0) return -1;
+    for (int n = 0; n < topo.nodeCount(); ++n)
+        if (std::binary_search(topo.nodeCpus[n].begin(), topo.nodeCpus[n].end(), cpu)) return n;
+    return -1;
+}
+
+#else // !__linux__
+
+NumaTopology loadNumaTopology(const std::string&) { return NumaTopology{}; }
+bool pinCurrentThreadToNode(const NumaTopology&, int) { return false; }
+int currentNumaNode(const NumaTopology&) { return -1; }
+
+#endif
+
+const NumaTopology& numaTopology() {
+    static const NumaTopology topo = loadNumaTopology();
+    return topo;
+}
@@ -0,0 +1,160 @@
+// src/shared_dataset.cpp
+#include "shared_dataset.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PG_HAVE_POSIX_SHM 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr char kMagic[4] = {'P', 'G', 'S', 'D'};
+static constexpr uint32_t kVersion = 1;
+
+static inline uint64_t alignUp(uint64_t v) { return (v + 63) & ~uint64_t(63); }
+
+#if PG_HAVE_POSIX_SHM
+
+static void setError(std::string* error, const std::string& what) {
+    if (error) *error = what + ": " + std::strerror(errno);
+}
+
+// Map the whole segment behind fd (ownership of fd passes to ds)
+static bool mapFd(int fd, size_t bytes, SharedDataset& ds, std::string* error) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) { setError(error, "mmap"); close(fd); return false; }
+    ds.base = p; ds.bytes = bytes; ds.fd = fd;
+    ds.header = static_cast<SharedDatasetHeader*>(p);
+    return true;
+}
+
+static void bindViews(SharedDataset& ds) {
+    char* b = static_cast<char*>(ds.base);
+    ds.points  = reinterpret_cast<std::array<float,2>*>(b + ds.header->pointsOffset);
+    ds.results = reinterpret_cast<SharedLabelResult*>(b + ds.header->resultsOffset);
+}
+
+bool createSharedDataset(const std::string& name, size_t count, SharedDataset& ds, std::string* error) {
+    const uint64_t pointsOffset  = alignUp(sizeof(SharedDatasetHeader));
+    const uint64_t resultsOffset = alignUp(pointsOffset + count * sizeof(std::array<float,2>));
+    const uint64_t bytes         = alignUp(resultsOffset + count * sizeof(SharedLabelResult));
+
+    int fd = -1;
+    if (name.empty()) {
+#if defined(__linux__)
+        fd = memfd_create("pg_dataset", MFD_CLOEXEC);
+        if (fd < 0) { setError(error, "memfd_create"); return false; }
+#else
+        if (error) *error = "Anonymous datasets need Linux memfd; pass a shm name";
+        return false;
+#endif
+    } else {
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) { setError(error, "shm_open " + name); return false; }
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        setError(error, "ftruncate");
+        close(fd);
+        if (!name.empty()) shm_unlink(name.c_str());
+        return false;
+    }
+    if (!mapFd(fd, (size_t)bytes, ds, error)) {
+        if (!name.empty()) shm_unlink(name.c_str());
+        return false;
+    }
+    // Fresh pages are zero; fill the header, state last
+    SharedDatasetHeader* h = ds.header;
+    std::memcpy(h->magic, kMagic, 4);
+    h->version = kVersion;
+    h->count = count;
+    h->pointsOffset = pointsOffset;
+    h->resultsOffset = resultsOffset;
+    h->bytes = bytes;
+    h->state.store(kSharedEmpty, std::memory_order_release);
+    bindViews(ds);
+    return true;
+}
+
+static bool openMapped(int fd, SharedDataset& ds, std::string* error) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) { setError(error, "fstat"); close(fd); return false; }
+    if ((size_t)st.st_size < sizeof(SharedDatasetHeader)) {
+        if (error) *error = "Segment too small for a dataset header";
+        close(fd); return false;
+    }
+    if (!mapFd(fd, (size_t)st.st_size, ds, error)) return false;
+    const SharedDatasetHeader* h = ds.header;
+    if (h->count > ds.bytes || h->pointsOffset > ds.bytes || h->resultsOffset > ds.bytes) { // guards the arithmetic below
+        if (error) *error = "Not a PGSD v1 dataset segment";
+        closeSharedDataset(ds);
+        return false;
+    }
+    const uint64_t need = std::max(h->resultsOffset + h->count * sizeof(SharedLabelResult),
+                                   h->pointsOffset + h->count * sizeof(std::array<float,2>));
+    if (std::memcmp(h->magic, kMagic, 4) != 0 || h->version != kVersion ||
+        h->bytes > ds.bytes || need > ds.bytes) {
+        if (error) *error = "Not a PGSD v1 dataset segment";
+        closeSharedDataset(ds);
+        return false;
+    }
+    bindViews(ds);
+    return true;
+}
+
+bool openSharedDataset(const std::string& name, SharedDataset& ds, std::string* error) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) { setError(error, "shm_open " + name); return false; }
+    return openMapped(fd, ds, error);
+}
+
+bool openSharedDatasetFd(int fd, SharedDataset& ds, std::string* error) {
+    const int own = dup(fd);
+    if (own < 0) { setError(error, "dup"); return false; }
+    return openMapped(own, ds, error);
+}
+
+void closeSharedDataset(SharedDataset& ds) {
+    if (ds.base) munmap(ds.base, ds.bytes);
+    if (ds.fd >= 0) close(ds.fd);
+    ds = SharedDataset{};
+}
+
+bool unlinkSharedDataset(const std::string& name) {
+    return !name.empty() && shm_unlink(name.c_str()) == 0;
+}
+
+#else // !PG_HAVE_POSIX_SHM
+
+static bool unsupported(std::string* error) {
+    if (error) *error = "Shared-memory datasets need a POSIX platform";
+    return false;
+}
+
+bool createSharedDataset(const std::string&, size_t, SharedDataset&, std::string* error) { return unsupported(error); }
+bool openSharedDataset(const std::string&, SharedDataset&, std::string* error) { return unsupported(error); }
+bool openSharedDatasetFd(int, SharedDataset&, std::string* error) { return unsupported(error); }
+void closeSharedDataset(SharedDataset& ds) { ds = SharedDataset{}; }
+bool unlinkSharedDataset(const std::string&) { return false; }
+
+#endif
+
+// -------------------- labeling claim --------------------
+SharedLabelingGuard::SharedLabelingGuard(SharedDataset& ds) : ds_(ds) {
+    if (!ds_.header) { observed_ = kSharedEmpty; return; }
+    claimed_ = ds_.header->state.compare_exchange_strong(observed_, kSharedLabeling);
+}
+
+SharedLabelingGuard::~SharedLabelingGuard() {
+    if (claimed_ && !finished_ && ds_.header) ds_.header->state.store(kSharedFailed, std::memory_order_release);
+}
+
+void SharedLabelingGuard::done() {
+    if (!claimed_ || finished_ || !ds_.header) return;
+    ds_.header->state.store(kSharedDone, std::memory_order_release);
+    finished_ = true;
+}
@@ -0,0 +1,138 @@
+// src/threshold_codec.cpp
+#include "threshold_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+static constexpr double kCodeSteps = 65534.0; // codes 1..65535
+static constexpr char kMagic[4] = {'L', 'Q', '1', '6'};
+static constexpr uint32_t kVersion = 1;
+
+// -------------------- threshold codes --------------------
+ThresholdCodec makeThresholdCodec(float smin, float smax) {
+    ThresholdCodec c;
+    c.smin = std::max(smin, 1e-30f);
+    c.smax = std::max(smax, c.smin);
+    c.logMin = std::log(c.smin);
+    c.logRange = std::log(c.smax) - c.logMin;
+    return c;
+}
+
+uint16_t encodeThreshold(const ThresholdCodec& c, float size) {
+    if (!(size >= c.smin) || !std::isfinite(size)) return 0; // below smin: no label
+    if (c.logRange <= 0.f) return 1;
+    const double t = (std::log((double)size) - c.logMin) / c.logRange;
+    uint32_t code = (t >= 1.0 || size >= c.smax) ? 65535u
+                  : 1u + (uint32_t)std::floor(std::max(0.0, t) * kCodeSteps);
+    // Round down: float log/exp may land one step above the true value
+    while (code > 1 && decodeThreshold(c, (uint16_t)code) > size) --code;
+    return (uint16_t)std::min<uint32_t>(code, 65535u);
+}
+
+float decodeThreshold(const ThresholdCodec& c, uint16_t code) {
+    if (code == 0) return 0.f;
+    if (code == 1) return c.smin; // exact ends (exp(log(x)) may miss x by an ulp)
+    const float s = (float)std::exp((double)c.logMin + (double)(code - 1) / kCodeSteps * c.logRange);
+    return std::min(s, c.smax);
+}
+
+// -------------------- quantized label sets --------------------
+QuantizedLabelSet quantizeLabels(const std::vector<double>& xs, const std::vector<double>& ys,
+                                 const std::vector<float>& sizes, const std::vector<int>& corners,
+                                 const std::vector<unsigned char>& labeled, const ThresholdCodec& codec) {
+    QuantizedLabelSet set;
+    set.codec = codec;
+    const size_t N = std::min({xs.size(), ys.size(), sizes.size(), corners.size(), labeled.size()});
+    if (N == 0) return set;
+
+    double minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+    for (size_t i = 0; i < N; ++i) {
+        minX = std::min(minX, xs[i]); maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]); maxY = std::max(maxY, ys[i]);
+    }
+    set.originX = minX; set.originY = minY;
+    set.scaleX = maxX > minX ? (maxX - minX) / 65535.0 : 1.0;
+    set.scaleY = maxY > minY ? (maxY - minY) / 65535.0 : 1.0;
+
+    // Rounding moves each position by up to half a step per axis, so two decoded labels (or a
+    // label and a point) can close in by one step: thresholds are lowered by the larger step.
+    const double posStep = std::max(maxX > minX ? set.scaleX : 0.0, maxY > minY ? set.scaleY : 0.0);
+
+    auto quant = [](double v, double o, double s) {
+        const double q = std::round((v - o) / s);
+        return (uint16_t)std::min(65535.0, std::max(0.0, q));
+    };
+    set.records.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+        auto& r = set.records[i];
+        r.qx = quant(xs[i], set.originX, set.scaleX);
+        r.qy = quant(ys[i], set.originY, set.scaleY);
+        if (!labeled[i]) { r.label = packLabel(0, corners[i]); continue; }
+        const double lowered = (double)sizes[i] - posStep;
+        float t = (float)lowered;
+        if ((double)t > lowered) t = std::nextafter(t, 0.f);
+        r.label = packLabel(encodeThreshold(codec, t), corners[i]);
+    }
+    return set;
+}
+
+// -------------------- file I/O --------------------
+// Raw little-endian layout (x86/ARM hosts):
+//   "LQ16" | u32 version | u64 count | f32 smin, smax | f64 originX, originY, scaleX, scaleY | records
+template <class T>
+static void putRaw(std::ofstream& out, const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+template <class T>
+static bool getRaw(std::ifstream& in, T& v) { return (bool)in.read(reinterpret_cast<char*>(&v), sizeof(T)); }
+
+bool writeQuantizedLabels(const std::string& path, const QuantizedLabelSet& set) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(kMagic, 4);
+    putRaw(out, kVersion);
+    putRaw(out, (uint64_t)set.records.size());
+    putRaw(out, set.codec.smin); putRaw(out, set.codec.smax);
+    putRaw(out, set.originX); putRaw(out, set.originY);
+    putRaw(out, set.scaleX);  putRaw(out, set.scaleY);
+    static_assert(sizeof(QuantizedLabelRecord) == 8, "record must be packed to 8 bytes");
+    out.write(reinterpret_cast<const char*>(set.records.data()),
+              (std::streamsize)(set.records.size() * sizeof(QuantizedLabelRecord)));
+    return (bool)out;
+}
+
+bool readQuantizedLabels(const std::string& path, QuantizedLabelSet& set, std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { if (error) *error = "Failed to open input: " + path; return false; }
+    char magic[4];
+    uint32_t version = 0; uint64_t count = 0; float smin = 0.f, smax = 0.f;
+    if (!in.read(magic, 4) || std::memcmp(magic, kMagic, 4) != 0 || !getRaw(in, version) || version != kVersion) {
+        if (error) *error = "Not an LQ16 v1 file: " + path;
+        return false;
+    }
+    if (!getRaw(in, count) || !getRaw(in, smin) || !getRaw(in, smax) ||
+        !getRaw(in, set.originX) || !getRaw(in, set.originY) ||
+        !getRaw(in, set.scaleX) || !getRaw(in, set.scaleY)) {
+        if (error) *error = "Truncated LQ16 header: " + path;
+        return false;
+    }
+    set.codec = makeThresholdCodec(smin, smax);
+    // Check the count against the bytes left before allocating (corrupt or truncated files)
+    const std::streampos recordsBegin = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff left = in.tellg() - recordsBegin;
+    in.seekg(recordsBegin);
+    if (!in || left < 0 || count > (uint64_t)left / sizeof(QuantizedLabelRecord)) {
+        if (error) *error = "LQ16 record count " + std::to_string(count) + " exceeds file size: " + path;
+        set.records.clear();
+        return false;
+    }
+    set.records.resize((size_t)count);
+    if (!in.read(reinterpret_cast<char*>(set.records.data()),
+                 (std::streamsize)(set.records.size() * sizeof(QuantizedLabelRecord)))) {
+        if (error) *error = "Truncated LQ16 records: " + path;
+        set.records.clear();
+        return false;
+    }
+    return true;
+}
@@ -2,6 +2,8 @@
 #include "visualizer.hpp"
 #include "ui_controls.hpp"
 #include "greedy_labeler.hpp"
+#include "threshold_codec.hpp"
+#include "geo_tiles.hpp"
 
 #define GLFW_INCLUDE_NONE
 #include <glad/glad.h>
@@ -15,6 +17,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>   // std::any_of, std::max
+#include <cstddef>     // offsetof
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -183,44 +186,73 @@ void PointLabelVisualizer::loadShaders() {
     ptProgram_ = linkProgram(shaderDir_ + "/point.vert", shaderDir_ + "/point.frag");
     sqProgram_ = linkProgram(shaderDir_ + "/label.vert", shaderDir_ + "/label.frag");
     uViewPt_   = glGetUniformLocation(ptProgram_, "u_view");
+    uTileOriginPt_ = glGetUniformLocation(ptProgram_, "u_tileOrigin");
+    uTileScalePt_  = glGetUniformLocation(ptProgram_, "u_tileScale");
     uViewSq_   = glGetUniformLocation(sqProgram_, "u_view");
+    uLogMinSq_   = glGetUniformLocation(sqProgram_, "u_logMin");
+    uLogRangeSq_ = glGetUniformLocation(sqProgram_, "u_logRange");
 }
 
 // -----------------------------------------------------------------------------
 // GPU buffers
 // -----------------------------------------------------------------------------
 void PointLabelVisualizer::buildPointBuffer() {
-    ptsCount_ = static_cast<int>(config_.points.size());
+    // 16-bit normalized positions per tile (4 bytes/point); the tile transform is a uniform.
+    // Only the tile-major index order is kept on the CPU: each tile is quantized into one
+    // tile-sized staging buffer and streamed into the GL buffer.
+    QuantizedTileLayout layout = planQuantizedTiles(config_.points);
+    ptsCount_ = static_cast<int>(layout.order.size());
 
     if (!ptsVAO_) glGenVertexArrays(1, &ptsVAO_);
     if (!ptsVBO_) glGenBuffers(1, &ptsVBO_);
 
+    using Q16 = std::array<uint16_t,2>;
     glBindVertexArray(ptsVAO_);
     glBindBuffer(GL_ARRAY_BUFFER, ptsVBO_);
-    glBufferData(GL_ARRAY_BUFFER,
-                 ptsCount_ * 2 * sizeof(float),
-                 config_.points.empty() ? nullptr : config_.points.data(),
-                 GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(layout.order.size() * sizeof(Q16)),
+                 nullptr, GL_STATIC_DRAW); // storage only, no client copy
+    std::vector<Q16> staging;
+    for (const auto& t : layout.tiles) {
+        staging.resize(t.count);
+        quantizeTile(config_.points, layout, t, staging.data());
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        static_cast<GLintptr>(t.begin * sizeof(Q16)),
+                        static_cast<GLsizeiptr>(t.count * sizeof(Q16)),
+                        staging.data());
+    }
+    ptTiles_ = std::move(layout.tiles);
+    glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_TRUE, 0, (void*)0);
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 }
 
-// Pack a rectangle (4 segments) into a flat vertex list
-static inline void appendRectLines(const Rect& r, std::vector<float>& verts) {
-    const float x0 = r.xmin, y0 = r.ymin, x1 = r.xmax, y1 = r.ymax;
-    verts.insert(verts.end(), {
-        x0, y0,  x1, y0,
-        x1, y0,  x1, y1,
-        x1, y1,  x0, y1,
-        x0, y1,  x0, y0
-    });
+// One label instance: anchor + packed 16-bit size code / corner (12 bytes instead of 8 line vertices)
+struct LabelInstance {
+    float    x, y;
+    uint32_t label;
+};
+
+// Collect valid candidates as instances; the size codec spans the valid sizes
+static ThresholdCodec packLabelInstances(const std::vector<LabelCandidate>& cands,
+                                         std::vector<LabelInstance>& out) {
+    out.clear();
+    float lo = 0.f, hi = 0.f;
+    for (const auto& c : cands) {
+        if (!c.valid || !(c.size > 0.f) || !std::isfinite(c.size)) continue;
+        if (out.empty()) { lo = hi = c.size; }
+        lo = std::min(lo, c.size); hi = std::max(hi, c.size);
+        out.push_back({c.anchor[0], c.anchor[1], 0u});
+    }
+    const ThresholdCodec codec = makeThresholdCodec(out.empty() ? 1.f : lo, out.empty() ? 1.f : hi);
+    size_t k = 0;
+    for (const auto& c : cands) {
+        if (!c.valid || !(c.size > 0.f) || !std::isfinite(c.size)) continue;
+        out[k++].label = packLabel(encodeThreshold(codec, c.size), c.corner);
+    }
+    return codec;
 }
 
 void PointLabelVisualizer::buildLabelBuffer() {
-    std::vector<float> verts;
-    verts.reserve(config_.candidates.size() * 16); // 8 verts * 2 floats
-
     // If nothing is marked valid yet, do a one-shot greedy so users see labels.
     const bool anyValid = std::any_of(config_.candidates.begin(), config_.candidates.end(),
                                       [](const LabelCandidate& c){ return c.valid; });
@@ -228,8 +260,10 @@ void PointLabelVisualizer::buildLabelBuffer() {
         greedyPlaceOneLabelPerPoint(config_.candidates, config_.points);
     }
 
-    for (const auto& c : config_.candidates)
-        if (c.valid) appendRectLines(getAABB(c), verts);
+    std::vector<LabelInstance> inst;
+    inst.reserve(config_.points.size());
+    const ThresholdCodec codec = packLabelInstances(config_.candidates, inst);
+    sqLogMin_ = codec.logMin; sqLogRange_ = codec.logRange;
 
     if (!sqVAO_) glGenVertexArrays(1, &sqVAO_);
     if (!sqVBO_) glGenBuffers(1, &sqVBO_);
@@ -237,38 +271,43 @@ void PointLabelVisualizer::buildLabelBuffer() {
     glBindVertexArray(sqVAO_);
     glBindBuffer(GL_ARRAY_BUFFER, sqVBO_);
     glBufferData(GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(verts.size() * sizeof(float)),
-                 verts.empty() ? nullptr : verts.data(),
+                 static_cast<GLsizeiptr>(inst.size() * sizeof(LabelInstance)),
+                 inst.empty() ? nullptr : inst.data(),
                  GL_DYNAMIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    // Per-instance attributes: anchor (float2) + packed label (uint, integer attribute)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(LabelInstance), (void*)0);
     glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(LabelInstance), (void*)offsetof(LabelInstance, label));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
     glBindVertexArray(0);
 
-    sqCount_ = static_cast<int>(verts.size() / 2);
+    sqCount_ = static_cast<int>(inst.size());
 }
 
 void PointLabelVisualizer::updateLabelBuffer() {
     if (!sqVBO_) { buildLabelBuffer(); return; }
 
-    std::vector<float> verts;
-    verts.reserve(config_.candidates.size() * 16);
-    for (const auto& c : config_.candidates)
-        if (c.valid) appendRectLines(getAABB(c), verts);
+    std::vector<LabelInstance> inst;
+    inst.reserve(config_.points.size());
+    const ThresholdCodec codec = packLabelInstances(config_.candidates, inst);
+    sqLogMin_ = codec.logMin; sqLogRange_ = codec.logRange;
 
     glBindBuffer(GL_ARRAY_BUFFER, sqVBO_);
-    const GLsizeiptr newSize = static_cast<GLsizeiptr>(verts.size() * sizeof(float));
+    const GLsizeiptr newSize = static_cast<GLsizeiptr>(inst.size() * sizeof(LabelInstance));
     GLint oldSize = 0;
     glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &oldSize);
 
     if (newSize != oldSize) {
         glBufferData(GL_ARRAY_BUFFER, newSize,
-                     verts.empty() ? nullptr : verts.data(),
+                     inst.empty() ? nullptr : inst.data(),
                      GL_DYNAMIC_DRAW);
     } else if (newSize > 0) {
-        glBufferSubData(GL_ARRAY_BUFFER, 0, newSize, verts.data());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, newSize, inst.data());
     }
 
-    sqCount_ = static_cast<int>(verts.size() / 2);
+    sqCount_ = static_cast<int>(inst.size());
 }
 
 // -----------------------------------------------------------------------------
@@ -293,13 +332,24 @@ void PointLabelVisualizer::renderFrame() {
     glUniformMatrix4fv(uViewPt_, 1, GL_FALSE, &proj[0][0]);
     glBindVertexArray(ptsVAO_);
     glPointSize(3.f);
-    glDrawArrays(GL_POINTS, 0, ptsCount_);
+    // One draw per visible tile (tiles outside the view are skipped)
+    const float viewX0 = -aspect/zoom_ + offsetX_, viewX1 = aspect/zoom_ + offsetX_;
+    const float viewY0 = -1.f/zoom_ + offsetY_,    viewY1 = 1.f/zoom_ + offsetY_;
+    for (const auto& t : ptTiles_) {
+        if (t.originX > viewX1 || t.originX + t.scaleX < viewX0 ||
+            t.originY > viewY1 || t.originY + t.scaleY < viewY0) continue;
+        glUniform2f(uTileOriginPt_, t.originX, t.originY);
+        glUniform2f(uTileScalePt_, t.scaleX, t.scaleY);
+        glDrawArrays(GL_POINTS, static_cast<GLint>(t.begin), static_cast<GLsizei>(t.count));
+    }
 
     // labels
     glUseProgram(sqProgram_);
     glUniformMatrix4fv(uViewSq_, 1, GL_FALSE, &proj[0][0]);
+    glUniform1f(uLogMinSq_, sqLogMin_);
+    glUniform1f(uLogRangeSq_, sqLogRange_);
     glBindVertexArray(sqVAO_);
-    glDrawArrays(GL_LINES, 0, sqCount_);
+    glDrawArraysInstanced(GL_LINES, 0, 8, sqCount_); // 4 outline segments per label
 }
 
 // -----------------------------------------------------------------------------
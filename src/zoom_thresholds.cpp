@@ -0,0 +1,255 @@
+// src/zoom_thresholds.cpp
+#include "zoom_thresholds.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ---------------- Batch / hybrid search for uniform zoom thresholds ----------------
+// Per-scale test (all probes of one search share the probe state, as before). Probes are
+// independent sizes, so the cached point grid is dropped like greedyPlaceOneLabelPerPoint
+// does: each probe indexes the points at its own size.
+static void runAtScale(const std::vector<std::array<float,2>>& pts, float S,
+                       MonotoneState& probeState, const PlacementOptions& opts,
+                       std::vector<unsigned char>& aliveOut,
+                       std::vector<int>& chosenCorner) {
+    auto cand = generateLabelCandidates(pts, S);
+    probeState.pointIndex.reset();
+    greedyPlaceMonotone(cand, pts, S, &probeState, opts);
+    int N = (int)pts.size();
+    aliveOut.assign(N, 0);
+    chosenCorner.assign(N, -1);
+    for (int i=0;i<N;++i) {
+        for (int c=0;c<4;++c) {
+            const auto &C = cand[i*4 + c];
+            if (C.valid) { aliveOut[i]=1; chosenCorner[i]=C.corner; break; }
+        }
+    }
+}
+
+struct Interval { float lo, hi; bool resolved; };
+
+// Probe sizes for one log-space refinement round: the fewest sizes that hit the middle half (in
+// log space) of every unresolved interval. Intervals are taken by the right end of their middle
+// half; a cluster gathers all intervals whose middle half starts before that end, and probes at
+// the log midpoint of their common part, so every interval of the cluster loses at least a
+// quarter of its log width.
+template <class Tight>
+static std::vector<float> logClusterProbes(const std::vector<Interval>& iv, Tight tight) {
+    std::vector<std::pair<double,double>> mid; // log middle half [a, b]
+    mid.reserve(iv.size());
+    for (const auto& v : iv) {
+        if (v.resolved || tight(v.lo, v.hi)) continue;
+        const double l = std::log((double)v.lo), w = std::log((double)v.hi) - l;
+        mid.push_back({l + 0.25 * w, l + 0.75 * w});
+    }
+    std::sort(mid.begin(), mid.end(), [](const auto& x, const auto& y){ return x.second < y.second; });
+    std::vector<float> probes;
+    for (size_t k = 0; k < mid.size(); ) {
+        const double b = mid[k].second;
+        double a = mid[k].first;
+        size_t e = k;
+        while (e < mid.size() && mid[e].first <= b) a = std::max(a, mid[e++].first);
+        probes.push_back((float)std::exp(0.5 * (a + b)));
+        k = e;
+    }
+    return probes;
+}
+
+ThresholdResult computeZoomThresholds(const std::vector<std::array<float,2>>& pts,
+                                      float Smin, float Smax,
+                                      float eps, float growth,
+                                      int maxGrowth, int maxRefine,
+                                      bool multiSample, int multiSamples,
+                                      float tolRel, const PlacementOptions& opts) {
+    ThresholdResult r; int N = (int)pts.size();
+    r.size.assign(N, Smin); r.corner.assign(N, 0); r.upper.assign(N, Smax); r.labeled.assign(N, 0);
+    if (N == 0) return r;
+    MonotoneState probeState;
+
+    // Termination + split point. With tolRel > 0 intervals are bisected in log space and
+    // resolved once hi/lo <= 1+tolRel, so precision is relative to each point's threshold
+    // (constant on-screen zoom precision) instead of an absolute eps over the whole span.
+    const bool logMode = tolRel > 0.f;
+    auto tight = [&](float lo, float hi) {
+        return logMode ? (hi <= lo * (1.f + tolRel)) : (hi - lo <= eps);
+    };
+    auto split = [&](float lo, float hi) {
+        return logMode ? std::sqrt(lo * hi) : 0.5f * (lo + hi);
+    };
+
+    std::vector<Interval> iv(N, {Smin, Smax, false});
+    std::vector<int> alive(N, 1);
+
+    // Optional geometric sweep pre-pass to densify sampling
+    if (multiSample) {
+        if (multiSamples <= 0) {
+            // choose count so that growth^k ~ Smax/Smin => k ~ log(Smax/Smin)/log(growth)
+            multiSamples = std::max(8, (int)std::ceil(std::log(Smax/Smin)/std::log(growth))); // ensure >=8
+        }
+        float logMin = std::log(Smin);
+        float logMax = std::log(Smax);
+        for (int i=0;i<multiSamples;i++) {
+            float t = (multiSamples==1)?0.f : (float)i/(multiSamples-1);
+            float S = std::exp(logMin + t*(logMax - logMin));
+            std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
+            runAtScale(pts, S, probeState, opts, aliveNow, chosenNow);
+            r.sweepRuns++;
+            for (int p=0;p<N;++p) {
+                if (aliveNow[p]) {
+                    r.labeled[p] = 1;
+                    if (S > iv[p].lo) { // extend lower bound if bigger
+                        iv[p].lo = S; r.size[p] = S; if (chosenNow[p]>=0) r.corner[p]=chosenNow[p];
+                    }
+                } else {
+                    // shrink hi if first time dead above current lo
+                    if (S < iv[p].hi) iv[p].hi = S;
+                }
+            }
+        }
+        // mark resolved if tight already
+        for (int i=0;i<N;++i) if (tight(iv[i].lo, iv[i].hi)) iv[i].resolved = true;
+    }
+
+    // Growth phase (coarse expansion)
+    float S = (Smin > 0 ? Smin : 1e-4f);
+    for (int g=0; g<maxGrowth && S < Smax; ++g) {
+        std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
+        runAtScale(pts, S, probeState, opts, aliveNow, chosenNow);
+        r.growthRuns++;
+        for (int i=0;i<N;++i) {
+            if (aliveNow[i]) {
+                r.labeled[i] = 1; // also at S == Smin, where size stays Smin
+                if (S > iv[i].lo) { iv[i].lo = S; r.size[i]=S; if(chosenNow[i]>=0) r.corner[i]=chosenNow[i]; }
+            } else if (alive[i]) { iv[i].hi = S; alive[i]=0; }
+        }
+        bool anyAlive=false; for(int i=0;i<N;++i) if(alive[i]) { anyAlive=true; break; }
+        if(!anyAlive) break;
+        S *= growth; if (S > Smax) S = Smax;
+    }
+    for (int i=0;i<N;++i) if (alive[i]) iv[i].hi = std::min(iv[i].hi, Smax);
+
+    if (logMode) {
+        // Refinement in log space: every round probes one size per cluster of unresolved
+        // intervals, so each of them is split (not just those around one median) and a round
+        // shrinks every unresolved interval by at least a quarter of its log width.
+        for (int probes = 0; probes < maxRefine; ) {
+            const std::vector<float> round = logClusterProbes(iv, tight);
+            if (round.empty()) break;
+            for (float testS : round) {
+                if (probes++ >= maxRefine) break;
+                std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
+                runAtScale(pts, testS, probeState, opts, aliveNow, chosenNow);
+                r.refineRuns++;
+                for (int i=0;i<N;++i) {
+                    // Only intervals around the probe learn from it (placements are not monotone)
+                    if (iv[i].resolved || !(iv[i].lo < testS && testS < iv[i].hi)) continue;
+                    if (aliveNow[i]) { iv[i].lo = testS; r.size[i]=testS; r.labeled[i]=1; if(chosenNow[i]>=0) r.corner[i]=chosenNow[i]; }
+                    else { iv[i].hi = testS; }
+                    if (tight(iv[i].lo, iv[i].hi)) iv[i].resolved = true;
+                }
+            }
+        }
+        for (int i=0;i<N;++i) r.upper[i] = iv[i].hi;
+        return r;
+    }
+
+    // Refinement (batched median probing)
+    for (int iter=0; iter<maxRefine; ++iter) {
+        std::vector<float> mids; mids.reserve(N);
+        for (int i=0;i<N;++i) if(!iv[i].resolved && !tight(iv[i].lo, iv[i].hi)) mids.push_back(split(iv[i].lo, iv[i].hi));
+        if (mids.empty()) break;
+        std::nth_element(mids.begin(), mids.begin()+mids.size()/2, mids.end());
+        float testS = mids[mids.size()/2];
+        std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
+        runAtScale(pts, testS, probeState, opts, aliveNow, chosenNow);
+        r.refineRuns++;
+        bool anyUnresolved=false;
+        for (int i=0;i<N;++i) {
+            if (iv[i].resolved) continue;
+            if (aliveNow[i]) { iv[i].lo = testS; r.size[i]=testS; r.labeled[i]=1; if(chosenNow[i]>=0) r.corner[i]=chosenNow[i]; }
+            else { iv[i].hi = testS; }
+            if (tight(iv[i].lo, iv[i].hi)) iv[i].resolved = true; else anyUnresolved=true;
+        }
+        if (!anyUnresolved) break;
+    }
+    for (int i=0;i<N;++i) r.upper[i] = iv[i].hi;
+    return r;
+}
+
+// Descending monotone sweep: walk S from Smax down to Smin through ONE MonotoneState.
+// greedyPlaceMonotone keeps every label and adds new ones on zoom-out, inserting only the new
+// activations into the index it keeps in the state, so a point's threshold is the size at
+// which it became active. After a quiet interval the next coarse step is probed with
+// monotoneZoomOutAddsLabels (no placement, no state copy); if it would add labels (or the
+// previous interval changed the active set), the interval is walked in refineSteps finer
+// sub-steps instead, so changes are recorded at finer resolution.
+ThresholdResult computeZoomThresholdsMonotone(const std::vector<std::array<float,2>>& pts,
+                                              float Smin, float Smax,
+                                              float growth, int maxGrowth,
+                                              int refineSteps, const PlacementOptions& opts) {
+    ThresholdResult r; int N = (int)pts.size();
+    r.size.assign(N, Smin); r.corner.assign(N, 0); r.labeled.assign(N, 0);
+    if (N == 0 || !(Smax > Smin)) return r;
+
+    // Coarse step count so that the sweep lands exactly on Smin
+    int steps = (int)std::ceil(std::log(Smax/Smin)/std::log(growth));
+    steps = std::max(1, std::min(steps, std::max(1, maxGrowth)));
+    const float coarse = std::pow(Smin/Smax, 1.0f/(float)steps);
+    refineSteps = std::max(1, refineSteps);
+    const float fine = std::pow(coarse, 1.0f/(float)refineSteps);
+
+    MonotoneState state;
+    auto cand = generateLabelCandidates(pts, Smax);
+    std::vector<unsigned char> on(N, 0), now(N, 0); // point active in `state` / in the new placement
+    int activeCount = 0;
+
+    // Sync thresholds with the active set after a placement at size S; returns the number of
+    // points that joined or left it
+    auto record = [&](const MonotoneState& st, float S) {
+        std::fill(now.begin(), now.end(), 0);
+        for (int idx : st.active) now[idx / 4] = 1;
+        int changed = 0;
+        for (int pid = 0; pid < N; ++pid) {
+            if (now[pid] == on[pid]) continue;
+            if (now[pid]) { r.size[pid] = S; r.corner[pid] = st.fixedCorner[pid]; ++activeCount; }
+            else          { r.size[pid] = Smin; --activeCount; }
+            on[pid] = r.labeled[pid] = now[pid];
+            ++changed;
+        }
+        return changed;
+    };
+    greedyPlaceMonotone(cand, pts, Smax, &state, opts);
+    r.growthRuns++;
+    record(state, Smax);
+
+    float S = Smax;
+    bool busy = true; // previous interval changed the active set => skip the probe
+    for (int k = 1; k <= steps && activeCount < N; ++k) {
+        const float next = (k == steps) ? Smin : S * coarse;
+
+        // Probe the coarse step; skip it if no label would be added (the placement at `next`
+        // would equal the current one, so only the state's size moves)
+        if (!busy) {
+            r.growthRuns++;
+            if (!monotoneZoomOutAddsLabels(pts, next, &state, opts)) {
+                state.lastBase = next;
+                S = next;
+                continue;
+            }
+        }
+
+        // Changes inside [next, S): walk the interval in finer sub-steps
+        int changed = 0;
+        for (int j = 1; j <= refineSteps; ++j) {
+            const float Sj = (j == refineSteps) ? next : S * std::pow(fine, (float)j);
+            greedyPlaceMonotone(cand, pts, Sj, &state, opts);
+            r.refineRuns++;
+            changed += record(state, Sj);
+            if (activeCount == N) break;
+        }
+        busy = changed > 0;
+        S = next;
+    }
+    return r;
+}
@@ -0,0 +1,122 @@
+// tests/test_csv_reader.cpp
+// Header detection, delimiter selection and quoted fields of csv_reader.hpp.
+#include "csv_reader.hpp"
+#include "test_util.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::string writeTemp(const char* name, const std::string& text) {
+    const std::string path = std::string("csv_reader_") + name + ".csv";
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+}
+
+struct Loaded {
+    bool ok = false;
+    std::vector<double> xs, ys;
+    std::vector<float> w;
+    std::string err;
+};
+
+static Loaded load(const std::string& text, const std::string& xCol, const std::string& yCol,
+                   const std::string& wCol = "", char delim = 0) {
+    Loaded r;
+    const std::string path = writeTemp("case", text);
+    CsvOptions opts;
+    opts.delimiter = delim;
+    r.ok = readPointsCsvColumns(path, xCol, yCol, wCol, r.xs, r.ys, r.w, &r.err, opts);
+    std::remove(path.c_str());
+    return r;
+}
+
+int main() {
+    // Header by name
+    {
+        Loaded r = load("id,x,y\n1,0.5,1.5\n2,2.5,3.5\n", "x", "y");
+        CHECK(r.ok && r.xs.size() == 2);
+        CHECK(r.xs.size() == 2 && r.xs[0] == 0.5 && r.ys[1] == 3.5);
+    }
+    // Headerless: an empty or NaN field in an unselected / selected column keeps the first row
+    {
+        Loaded r = load("1,2,,7\n3,4,5,6\n", "0", "1");
+        CHECK_MSG(r.xs.size() == 2, "empty field: %zu rows", r.xs.size());
+        Loaded n = load("nan,2\n3,4\n", "0", "1");
+        CHECK_MSG(n.xs.size() == 2, "nan field: %zu rows", n.xs.size());
+        CHECK(n.xs.size() == 2 && std::isnan(n.xs[0]));
+        Loaded t = load("1,2,label text\n3,4,more\n", "0", "1");
+        CHECK_MSG(t.xs.size() == 2, "text in an unselected column: %zu rows", t.xs.size());
+    }
+    // Header by index: non-numeric selected field
+    {
+        Loaded r = load("lon,lat\n10,20\n", "0", "1");
+        CHECK(r.xs.size() == 1 && r.xs[0] == 10.0);
+    }
+    // Unknown name
+    {
+        Loaded r = load("a,b\n1,2\n", "x", "b");
+        CHECK(!r.ok && !r.err.empty());
+    }
+    // Delimiters: detected ';' / tab / '|', explicit override
+    {
+        Loaded s = load("x;y\n1.5;2.5\n", "x", "y");
+        CHECK(s.xs.size() == 1 && s.xs[0] == 1.5 && s.ys[0] == 2.5);
+        Loaded t = load("x\ty\tz\n1\t2\t3\n", "x", "z");
+        CHECK(t.xs.size() == 1 && t.xs[0] == 1.0 && t.ys[0] == 3.0);
+        Loaded p = load("x|y\n4|5\n", "x", "y");
+        CHECK(p.xs.size() == 1 && p.ys[0] == 5.0);
+        // ';' is only a delimiter when asked for: with ',' explicit, "1;2" is one field
+        Loaded e = load("name,x,y\na;b,1,2\n", "x", "y", "", ',');
+        CHECK(e.xs.size() == 1 && e.xs[0] == 1.0);
+        CHECK(detectCsvDelimiter("a;b;c,d") == ';');
+        CHECK(detectCsvDelimiter("\"a;b;c\",d") == ',');
+        CHECK(detectCsvDelimiter("single") == ',');
+        char d = 0;
+        CHECK(parseCsvDelimiter("tab", d) && d == '\t');
+        CHECK(parseCsvDelimiter(";", d) && d == ';');
+        CHECK(!parseCsvDelimiter(",,", d));
+    }
+    // Quoted fields: delimiters and escaped quotes inside, quoted numbers
+    {
+        Loaded r = load("\"name, with comma\",\"x\",\"y\"\n\"Smith, \"\"J\"\"\",\"1.25\",2\n", "x", "y");
+        CHECK(r.ok && r.xs.size() == 1);
+        CHECK(r.xs.size() == 1 && r.xs[0] == 1.25 && r.ys[0] == 2.0);
+        const auto f = splitCsvLine("\"a,b\", \"c\"\"d\" ,e", ',');
+        CHECK(f.size() == 3 && f[0] == "a,b" && f[1] == "c\"d" && f[2] == "e");
+    }
+    // Wide record: selected columns far to the right, weights
+    {
+        std::string head, row;
+        for (int c = 0; c < 40; ++c) {
+            head += (c ? "," : "") + std::string("c") + std::to_string(c);
+            row  += (c ? "," : "") + std::to_string(c);
+        }
+        Loaded r = load(head + "\n" + row + "\n", "c31", "c7", "c39");
+        CHECK(r.xs.size() == 1 && r.xs[0] == 31.0 && r.ys[0] == 7.0);
+        CHECK(r.w.size() == 1 && r.w[0] == 39.f);
+    }
+    // "name|index" specs: by name with a header (absent = missing column), by index without
+    {
+        std::vector<std::string> header = {"x", "y", "side", "size", "corner"};
+        CHECK(resolveCsvColumn("corner|3", header) == 4);
+        CHECK(resolveCsvColumn("corner|3", {}) == 3);
+        CHECK(resolveCsvColumn("weight|2", header) == -1);
+        CHECK(isCsvHeader(header, {"0", "1", "side|2", "corner|3"}));
+        CHECK(!isCsvHeader({"1", "2", "", "nan"}, {"0", "1", "side|2", "corner|3"}));
+        CHECK(isCsvHeader({"1", "2"}, {"x", "1"}));
+
+        const std::string path = writeTemp("named", "x,y,side,size,corner\n1,2,0.5,0.5,3\n");
+        std::vector<int> corners;
+        CHECK(forEachCsvRow(path, {"0", "1", "side|2", "corner|3"}, [&](const std::vector<CsvField>& f) {
+            float c = -1.f;
+            parseFloatField(f[3], c);
+            corners.push_back((int)c);
+        }));
+        CHECK(corners.size() == 1 && corners[0] == 3);
+        std::remove(path.c_str());
+    }
+    return testResult("test_csv_reader");
+}
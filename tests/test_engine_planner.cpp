@@ -0,0 +1,83 @@
+// tests/test_engine_planner.cpp
+// The planner only picks backends (rect index, corner algorithm, clearance cell, threads): for
+// the engine it chose, its placement options must give exactly the thresholds and corners of
+// the default options. Also checks the grid ring scan against all-pairs clearance for several
+// cell sizes.
+#include "engine_planner.hpp"
+#include "greedy_labeler.hpp"
+#include "zoom_thresholds.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using Points = std::vector<std::array<float,2>>;
+
+static ThresholdResult runEngine(ThresholdEngine engine, const Points& pts, float span,
+                                 const PlacementOptions& opts) {
+    // csv_labeler defaults
+    return engine == ThresholdEngine::Monotone
+        ? computeZoomThresholdsMonotone(pts, 1e-4f, span, 1.2f, 56, 4, opts)
+        : computeZoomThresholds(pts, 1e-4f, span, span * 6e-5f + 1e-6f, 1.2f, 56, 64, true, 0, 0.f, opts);
+}
+
+static void checkPlanMatchesDefault(const char* name, const Points& pts, float span) {
+    const EnginePlan plan = planEngine(pts, 1);
+    const ThresholdResult planned = runEngine(plan.engine, pts, span, plan.placement);
+    const ThresholdResult plain = runEngine(plan.engine, pts, span, PlacementOptions{});
+    int corners = 0, sizes = 0;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        corners += planned.corner[i] != plain.corner[i];
+        sizes += planned.size[i] != plain.size[i];
+    }
+    CHECK_MSG(corners == 0 && sizes == 0, "%s (%s engine, cell %g): %d corners, %d thresholds differ",
+              name, toString(plan.engine), plan.placement.cornerCellSize, corners, sizes);
+}
+
+static std::vector<int> cornersOf(const Points& pts, const PlacementOptions& opts) {
+    std::vector<LabelCandidate> cands = generateLabelCandidates(pts, 0.001f);
+    MonotoneState st;
+    greedyPlaceMonotone(cands, pts, 0.001f, &st, opts);
+    return st.fixedCorner;
+}
+
+static void checkGridMatchesBrute(const char* name, const Points& pts) {
+    PlacementOptions brute;
+    brute.corners = CornerPolicy::ClearanceBrute;
+    const std::vector<int> expected = cornersOf(pts, brute);
+    for (float cell : {0.1f, 1.f, 10.f, 50.f}) {
+        PlacementOptions grid;
+        grid.cornerCellSize = cell;
+        const std::vector<int> got = cornersOf(pts, grid);
+        int diff = 0;
+        for (size_t i = 0; i < pts.size(); ++i) diff += got[i] != expected[i];
+        CHECK_MSG(diff == 0, "%s: cell %g picks %d corners unlike the all-pairs scan", name, cell, diff);
+    }
+}
+
+int main() {
+    TestRng rng(23);
+    Points uniform;
+    for (int i = 0; i < 3000; ++i) uniform.push_back({(float)(100.0 * rng.next()), (float)(100.0 * rng.next())});
+
+    Points clustered; // 12 Gaussian clusters, skew far above the planner's clustered cutoff
+    for (int i = 0; i < 3000; ++i) {
+        const double cx = 10.0 + (i % 4) * 25.0, cy = 15.0 + (i % 3) * 30.0, r = 0.3 + (i % 5) * 0.4;
+        const double u = std::max(1e-12, rng.next()), v = rng.next();
+        const double d = r * std::sqrt(-2.0 * std::log(u));
+        clustered.push_back({(float)(cx + d * std::cos(6.283185307179586 * v)),
+                             (float)(cy + d * std::sin(6.283185307179586 * v))});
+    }
+
+    Points tiny; // below the linear-index and all-pairs cutoffs
+    for (int i = 0; i < 100; ++i) tiny.push_back({(float)(10.0 * rng.next()), (float)(10.0 * rng.next())});
+
+    checkPlanMatchesDefault("uniform 3k", uniform, 100.f);
+    checkPlanMatchesDefault("clustered 3k", clustered, 100.f);
+    checkPlanMatchesDefault("tiny 100", tiny, 10.f);
+
+    checkGridMatchesBrute("uniform 3k", uniform);
+    checkGridMatchesBrute("clustered 3k", clustered);
+    return testResult("test_engine_planner");
+}
@@ -0,0 +1,136 @@
+// tests/test_geo_tiles.cpp
+// Web Mercator projection (reference values, round trip through the inverse formula, latitude
+// clamp) and the labeling frame: data near zero keeps its input coordinates, data far from zero
+// is rebased to the extent center and keeps its precision in float32 offsets. 16-bit point tiles
+// come out in row-major tile order (stable within a tile) and dequantize within one step.
+#include "geo_tiles.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static constexpr double kR = 6378137.0;
+static constexpr double kDeg = 3.14159265358979323846 / 180.0;
+
+static void checkMercator() {
+    // Reference values: lon 180 -> half the EPSG:3857 world width, lat 85.05112878 -> same in y
+    std::vector<double> x = {0.0, 180.0, -180.0, 13.4050, 0.0}, y = {0.0, 85.05112878, -85.05112878, 52.5200, 89.9};
+    std::vector<double> lon = x, lat = y;
+    projectLonLatToMercator(x.data(), y.data(), x.size());
+    CHECK(x[0] == 0.0 && y[0] == 0.0);
+    CHECK_MSG(std::fabs(x[1] - 20037508.342789244) < 1e-6, "x(180) = %.9f", x[1]);
+    CHECK_MSG(std::fabs(y[1] - 20037508.342789244) < 1e-2, "y(85.0511) = %.9f", y[1]);
+    CHECK(x[2] == -x[1] && y[2] == -y[1]);
+    CHECK_MSG(y[4] == y[1], "latitude 89.9 not clamped to the Mercator limit (%.3f)", y[4]);
+
+    // Round trip: lon = x / R, lat = atan(sinh(y / R))
+    for (size_t i = 0; i < 4; ++i) {
+        const double lon2 = x[i] / (kR * kDeg), lat2 = std::atan(std::sinh(y[i] / kR)) / kDeg;
+        CHECK_MSG(std::fabs(lon2 - lon[i]) < 1e-9 && std::fabs(lat2 - lat[i]) < 1e-9,
+                  "point %zu: (%.12f, %.12f) -> (%.12f, %.12f)", i, lon[i], lat[i], lon2, lat2);
+    }
+}
+
+static void checkNearOrigin() {
+    // Unit square and [100,200]: centers within 8 extents of zero keep their input coordinates
+    TestRng rng(5);
+    for (double base : {0.0, 100.0}) {
+        const double ext = base > 0.0 ? 100.0 : 1.0;
+        std::vector<double> xs, ys;
+        for (int i = 0; i < 1000; ++i) { xs.push_back(base + ext * rng.next()); ys.push_back(base + ext * rng.next()); }
+        const LocalFrame f = buildLocalFrame(xs, ys);
+        CHECK_MSG(f.originX == 0.0 && f.originY == 0.0, "base %g: origin (%g, %g)", base, f.originX, f.originY);
+        int moved = 0;
+        for (size_t i = 0; i < xs.size(); ++i) moved += f.offsets[i][0] != (float)xs[i] || f.offsets[i][1] != (float)ys[i];
+        CHECK_MSG(moved == 0, "base %g: %d points not in input coordinates", base, moved);
+    }
+    CHECK(buildLocalFrame({}, {}).offsets.empty());
+}
+
+static void checkRebased() {
+    // Mercator-sized coordinates, 10 km extent, millimetre detail: float32 input would round to 1 m
+    TestRng rng(9);
+    const double cx = 1.5e7, cy = -4.2e6;
+    std::vector<double> xs, ys;
+    for (int i = 0; i < 1000; ++i) {
+        xs.push_back(cx - 5000.0 + 1e4 * rng.next());
+        ys.push_back(cy - 5000.0 + 1e4 * rng.next());
+    }
+    const LocalFrame f = buildLocalFrame(xs, ys);
+    const auto bx = std::minmax_element(xs.begin(), xs.end()), by = std::minmax_element(ys.begin(), ys.end());
+    CHECK_MSG(f.originX == 0.5 * (*bx.first + *bx.second) && f.originY == 0.5 * (*by.first + *by.second),
+              "origin (%.3f, %.3f) is not the extent center", f.originX, f.originY);
+    double worst = 0.0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        CHECK(std::fabs(f.offsets[i][0]) <= 5000.f && std::fabs(f.offsets[i][1]) <= 5000.f);
+        worst = std::max({worst, std::fabs(f.originX + f.offsets[i][0] - xs[i]),
+                          std::fabs(f.originY + f.offsets[i][1] - ys[i])});
+    }
+    CHECK_MSG(worst < 1e-3, "rebased offsets lose %.6f m", worst);
+
+    // Coincident far points: shifted to a zero offset, not left at ~1e7
+    const LocalFrame one = buildLocalFrame({cx, cx}, {cy, cy});
+    CHECK(one.originX == cx && one.originY == cy && one.offsets[0][0] == 0.f && one.offsets[1][1] == 0.f);
+}
+
+static void checkQuantizedTiles(const char* name, const std::vector<std::array<float,2>>& pts, int T) {
+    const QuantizedTileLayout layout = planQuantizedTiles(pts, T);
+    CHECK_MSG(layout.order.size() == pts.size(), "%s: %zu of %zu points tiled", name, layout.order.size(), pts.size());
+
+    // Same tile key as the counting sort: row-major over the extent, T x T tiles
+    float minX = pts[0][0], maxX = minX, minY = pts[0][1], maxY = minY;
+    for (const auto& p : pts) {
+        minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]);
+        minY = std::min(minY, p[1]); maxY = std::max(maxY, p[1]);
+    }
+    const float span = std::max(maxX - minX, maxY - minY);
+    const float inv = span > 0.f ? (float)T / span : 0.f;
+    auto keyOf = [&](const std::array<float,2>& p) {
+        return std::min(T - 1, (int)((p[1] - minY) * inv)) * T + std::min(T - 1, (int)((p[0] - minX) * inv));
+    };
+
+    std::vector<int> seen(pts.size(), 0);
+    uint32_t next = 0;
+    int prevKey = -1, misplaced = 0, unstable = 0, far = 0;
+    std::vector<std::array<uint16_t,2>> q;
+    for (const auto& t : layout.tiles) {
+        CHECK_MSG(t.begin == next && t.count > 0, "%s: tile at %u (expected %u), %u points", name, t.begin, next, t.count);
+        next = t.begin + t.count;
+        const int key = keyOf(pts[layout.order[t.begin]]);
+        CHECK_MSG(key > prevKey, "%s: tile key %d after %d", name, key, prevKey);
+        prevKey = key;
+
+        q.assign(t.count, {0, 0});
+        quantizeTile(pts, layout, t, q.data());
+        const double stepX = t.scaleX / 65535.0, stepY = t.scaleY / 65535.0;
+        for (uint32_t k = 0; k < t.count; ++k) {
+            const uint32_t i = layout.order[t.begin + k];
+            ++seen[i];
+            misplaced += keyOf(pts[i]) != key;
+            if (k > 0 && i < layout.order[t.begin + k - 1]) ++unstable;
+            const double x = t.originX + q[k][0] / 65535.0 * t.scaleX, y = t.originY + q[k][1] / 65535.0 * t.scaleY;
+            if (std::fabs(x - pts[i][0]) > stepX || std::fabs(y - pts[i][1]) > stepY) ++far;
+        }
+    }
+    CHECK_MSG(next == pts.size(), "%s: tiles cover %u of %zu points", name, next, pts.size());
+    CHECK_MSG(std::count(seen.begin(), seen.end(), 1) == (long)pts.size(), "%s: order is not a permutation", name);
+    CHECK_MSG(misplaced == 0 && unstable == 0, "%s: %d points in the wrong tile, %d out of input order", name, misplaced, unstable);
+    CHECK_MSG(far == 0, "%s: %d points dequantize more than one step away", name, far);
+}
+
+int main() {
+    checkMercator();
+    checkNearOrigin();
+    checkRebased();
+
+    TestRng rng(31);
+    std::vector<std::array<float,2>> pts;
+    for (int i = 0; i < 50000; ++i) pts.push_back({(float)(1000.0 * rng.next()), (float)(500.0 * rng.next())});
+    for (int i = 0; i < 20000; ++i) pts.push_back({(float)(700.0 + rng.next()), (float)(100.0 + 0.5 * rng.next())});
+    pts.push_back(pts[3]); // a duplicate
+    checkQuantizedTiles("uniform + dense cluster, 4x4 tiles", pts, 4);
+    checkQuantizedTiles("uniform + dense cluster, 16x16 tiles", pts, 16);
+    checkQuantizedTiles("coincident points", std::vector<std::array<float,2>>(10, {2.5f, -1.f}), 3);
+    return testResult("test_geo_tiles");
+}
@@ -0,0 +1,133 @@
+// tests/test_memory_model.cpp
+// Batch memory control of memory_model.hpp: row counts and estimates (the reader's header rule),
+// the per-point model, the calibration file (cold start, matching records, 64-run window) and
+// the admission decision (largest fitting job first, wait when full, oversized jobs alone).
+#include "memory_model.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::string writeTemp(const char* name, const std::string& text) {
+    const std::string path = std::string("memory_model_") + name + ".csv";
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+}
+
+static void checkRowCounts() {
+    // The reader's header rule, blank lines skipped, unterminated last row
+    const char* texts[] = {"nan,inf\n1,2\n\n3,4", "lon,lat\r\n10,20\r\n\r\n", "id;x;y\n1;2;3\n"};
+    const std::vector<std::string> specs[] = {{"0", "1", ""}, {"0", "1", ""}, {"x", "y", ""}};
+    for (int k = 0; k < 3; ++k) {
+        const std::string path = writeTemp("count", texts[k]);
+        std::vector<double> xs, ys;
+        std::vector<float> w;
+        CHECK(readPointsCsvColumns(path, specs[k][0], specs[k][1], "", xs, ys, w));
+        const size_t counted = countCsvRows(path, specs[k]);
+        const CsvRowEstimate est = estimateCsvRows(path, specs[k]);
+        CHECK_MSG(counted == xs.size(), "case %d: counted %zu, reader %zu", k, counted, xs.size());
+        CHECK_MSG(est.exact && est.rows == xs.size(), "case %d: estimated %zu", k, est.rows);
+        std::remove(path.c_str());
+    }
+    // Larger than the sample: scaled from the file size
+    std::string text = "x,y\n";
+    for (int i = 0; i < 20000; ++i) text += std::to_string(1000 + i % 9000) + ".5," + std::to_string(i % 7) + "\n";
+    const std::string path = writeTemp("estimate", text);
+    const CsvRowEstimate est = estimateCsvRows(path, {"x", "y"}, CsvOptions{}, 4096);
+    CHECK(countCsvRows(path, {"x", "y"}) == 20000);
+    CHECK_MSG(!est.exact && est.rows > 19000 && est.rows < 21000, "estimated %zu of 20000", est.rows);
+    std::remove(path.c_str());
+    CHECK(countCsvRows("memory_model_missing.csv", {"0", "1"}) == 0);
+}
+
+static void checkModel() {
+    const size_t n = 1000000;
+    const uint64_t search = estimatePeakBytes(n, "search"), monotone = estimatePeakBytes(n, "monotone");
+    CHECK_MSG(estimatePeakBytes(n, "auto") == std::max(search, monotone), "auto is not the larger engine");
+    CHECK(estimatePeakBytes(2 * n, "search") - search == search - estimatePeakBytes(0, "search"));
+    // Weights: one float per point; NUMA replicas only with several threads on several nodes
+    CHECK(estimatePeakBytes(n, "search", 1, 1, true) - search == n * sizeof(float));
+    CHECK(memoryModelFor("search", 1, 4).parallelPerPoint == 0);
+    CHECK(memoryModelFor("search", 8, 1).parallelPerPoint == 0);
+    CHECK(memoryModelFor("search", 8, 2).parallelPerPoint > 0);
+    CHECK(memoryModelFor("search", 8).baseBytes > memoryModelFor("search", 1).baseBytes);
+}
+
+static void checkCalibration() {
+    const std::string path = "memory_model_calib.csv";
+    std::remove(path.c_str());
+    MemoryCalibration cold = loadMemoryCalibration(path, "search", 1);
+    CHECK_MSG(cold.samples == 0 && cold.ratio == 1.5, "missing file: ratio %g, %d samples", cold.ratio, cold.samples);
+
+    // Only records of the same engine and thread count count; the worst ratio + 10% wins
+    CHECK(appendMemoryCalibration(path, 1000, 1000, 1200, "search", 1));
+    CHECK(appendMemoryCalibration(path, 1000, 1000, 900, "search", 1));
+    CHECK(appendMemoryCalibration(path, 1000, 1000, 5000, "search", 4));
+    CHECK(appendMemoryCalibration(path, 1000, 1000, 3000, "monotone", 1));
+    std::ofstream(path, std::ios::app) << "1000,1000,9000\n"; // old record without engine / threads
+    MemoryCalibration cal = loadMemoryCalibration(path, "search", 1);
+    CHECK_MSG(cal.samples == 2 && std::fabs(cal.ratio - 1.1 * 1.2) < 1e-12,
+              "search/1: ratio %g, %d samples", cal.ratio, cal.samples);
+    cal = loadMemoryCalibration(path, "search", 4);
+    CHECK(cal.samples == 1 && std::fabs(cal.ratio - 5.5) < 1e-12);
+    cal = loadMemoryCalibration(path, "auto", 1);
+    CHECK(cal.samples == 0 && cal.ratio == 1.5);
+
+    // Window: the under-estimate ages out after 64 newer runs
+    for (int i = 0; i < 64; ++i) CHECK(appendMemoryCalibration(path, 1000, 1000, 1000, "search", 1));
+    cal = loadMemoryCalibration(path, "search", 1);
+    CHECK_MSG(cal.samples == 64 && std::fabs(cal.ratio - 1.1) < 1e-12, "window: ratio %g, %d samples", cal.ratio, cal.samples);
+    std::remove(path.c_str());
+}
+
+static void checkAdmission() {
+    const uint64_t limit = 100;
+    // Largest fitting job first, next to the running ones
+    CHECK(nextBatchJob({80, 50, 20}, 0, 0, 4, limit) == 0);
+    CHECK(nextBatchJob({80, 50, 20}, 40, 1, 4, limit) == 1);
+    CHECK(nextBatchJob({80, 50, 20}, 60, 1, 4, limit) == 2);
+    // Budget full: wait for a running job
+    CHECK(nextBatchJob({80, 50, 20}, 90, 2, 4, limit) == -1);
+    // Concurrency cap, nothing pending
+    CHECK(nextBatchJob({10}, 0, 4, 4, limit) == -1);
+    CHECK(nextBatchJob({}, 0, 0, 4, limit) == -1);
+    // Over the whole budget: waits while anything runs, then starts alone
+    CHECK(nextBatchJob({150, 20}, 0, 0, 4, limit) == 1);
+    CHECK(nextBatchJob({150}, 20, 1, 4, limit) == -1);
+    CHECK(nextBatchJob({150}, 0, 0, 4, limit) == 0);
+
+    // A queue run to completion: the summed estimates stay within the budget except for the
+    // job that runs alone
+    std::vector<uint64_t> pending = {150, 70, 60, 40, 30, 10};
+    std::vector<uint64_t> running;
+    uint64_t inUse = 0;
+    int started = 0;
+    while (!pending.empty() || !running.empty()) {
+        long k;
+        while ((k = nextBatchJob(pending, inUse, running.size(), 3, limit)) >= 0) {
+            inUse += pending[(size_t)k];
+            running.push_back(pending[(size_t)k]);
+            pending.erase(pending.begin() + k);
+            ++started;
+            CHECK_MSG(inUse <= limit || running.size() == 1, "%zu jobs use %llu of %llu",
+                      running.size(), (unsigned long long)inUse, (unsigned long long)limit);
+        }
+        CHECK_MSG(!running.empty(), "%zu jobs pending, none running", pending.size());
+        if (running.empty()) break;
+        inUse -= running.front(); // oldest finishes first
+        running.erase(running.begin());
+    }
+    CHECK(started == 6);
+}
+
+int main() {
+    checkRowCounts();
+    checkModel();
+    checkCalibration();
+    checkAdmission();
+    return testResult("test_memory_model");
+}
@@ -0,0 +1,77 @@
+// tests/test_numa_corners.cpp
+// The per-NUMA-node corner selection (x-slab + halo replicas) must pick exactly the corners of
+// the single-node path, and its replicas must cover about one copy of the data in total
+// (not one full copy per node).
+#include "greedy_labeler.hpp"
+#include "numa_topology.hpp"
+#include "test_util.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using Points = std::vector<std::array<float,2>>;
+
+static std::vector<int> cornersOf(const Points& pts, const PlacementOptions& opts) {
+    std::vector<LabelCandidate> cands = generateLabelCandidates(pts, 0.001f);
+    MonotoneState st;
+    greedyPlaceMonotone(cands, pts, 0.001f, &st, opts);
+    return st.fixedCorner;
+}
+
+// Returns the replica bytes of the run
+static uint64_t checkSameCorners(const char* name, const Points& pts, float cell, int nodes) {
+    // Fake topology: every node runs on the CPUs this process already has, so pinning succeeds
+    // anywhere while the slab/halo partitioning is exercised as on a real multi-node machine.
+    const NumaTopology real = loadNumaTopology();
+    NumaTopology topo;
+    for (int n = 0; n < nodes; ++n) {
+        topo.nodeIds.push_back(n);
+        topo.nodeCpus.push_back(real.nodeCount() > 0 ? real.nodeCpus[0] : std::vector<int>{0});
+    }
+
+    PlacementOptions plain;
+    plain.cornerCellSize = cell;
+    plain.threads = 2 * nodes;
+    plain.numa = false;
+    const std::vector<int> expected = cornersOf(pts, plain);
+
+    ParallelStats stats;
+    PlacementOptions numa = plain;
+    numa.numa = true;
+    numa.topology = &topo;
+    numa.stats = &stats;
+    const std::vector<int> got = cornersOf(pts, numa);
+
+    int diff = 0;
+    for (size_t i = 0; i < pts.size(); ++i) diff += got[i] != expected[i];
+    CHECK_MSG(stats.numaNodes == nodes, "%s: ran on %d nodes", name, stats.numaNodes);
+    CHECK_MSG(diff == 0, "%s: %d of %zu corners differ from the single-node path", name, diff, pts.size());
+    CHECK_MSG(stats.haloMisses < pts.size() / 20, "%s: %llu halo misses", name, (unsigned long long)stats.haloMisses);
+    return stats.replicaBytes;
+}
+
+int main() {
+    TestRng rng(17);
+    Points uniform;
+    for (int i = 0; i < 40000; ++i) uniform.push_back({(float)rng.next(), (float)rng.next()});
+    const uint64_t two = checkSameCorners("uniform 40k / 2 nodes", uniform, 0.01f, 2);
+    const uint64_t four = checkSameCorners("uniform 40k / 4 nodes", uniform, 0.01f, 4);
+    // Full replicas would double the total from 2 to 4 nodes; slabs only add halo columns
+    CHECK_MSG(two > 0 && four < two * 5 / 4, "replica bytes: 2 nodes %llu, 4 nodes %llu",
+              (unsigned long long)two, (unsigned long long)four);
+
+    Points clustered;
+    for (int i = 0; i < 30000; ++i) {
+        const double cx = (i % 7) * 13.0, cy = (i % 5) * 11.0, r = 0.2 + (i % 3);
+        const double u = std::max(1e-12, rng.next()), v = rng.next();
+        const double d = r * std::sqrt(-2.0 * std::log(u));
+        clustered.push_back({(float)(cx + d * std::cos(6.283185307179586 * v)),
+                             (float)(cy + d * std::sin(6.283185307179586 * v))});
+    }
+    const uint64_t c2 = checkSameCorners("clustered 30k / 2 nodes", clustered, 0.1f, 2);
+    const uint64_t c3 = checkSameCorners("clustered 30k / 3 nodes", clustered, 0.1f, 3);
+    CHECK_MSG(c2 > 0 && c3 < c2 * 5 / 4, "replica bytes: 2 nodes %llu, 3 nodes %llu",
+              (unsigned long long)c2, (unsigned long long)c3);
+    return testResult("test_numa_corners");
+}
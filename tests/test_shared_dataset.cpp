@@ -0,0 +1,75 @@
+// tests/test_shared_dataset.cpp
+// Segment state transitions: only a Ready segment can be claimed, and a claim ends in Done
+// (done()) or Failed (guard destroyed first); points and results are shared through the mapping.
+#include "shared_dataset.hpp"
+#include "test_util.hpp"
+
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+int main() {
+#if defined(__unix__) || defined(__APPLE__)
+    SharedDataset ds;
+    std::string err;
+    const std::string name = "/pg_test_" + std::to_string((long)getpid());
+    if (!createSharedDataset(name, 3, ds, &err)) {
+        CHECK_MSG(false, "createSharedDataset: %s", err.c_str());
+        return testResult("test_shared_dataset");
+    }
+    auto state = [&]() { return ds.header->state.load(); };
+    CHECK(ds.count() == 3 && state() == kSharedEmpty);
+    for (int i = 0; i < 3; ++i) ds.points[i] = {(float)i, (float)-i};
+
+    // Not ready yet: the claim fails and leaves the state alone
+    {
+        SharedLabelingGuard g(ds);
+        CHECK(!g.claimed() && g.observedState() == kSharedEmpty);
+    }
+    CHECK(state() == kSharedEmpty);
+
+    // Claimed, then abandoned (early return / exception): Failed
+    ds.header->state.store(kSharedReady);
+    {
+        SharedLabelingGuard g(ds);
+        CHECK(g.claimed() && state() == kSharedLabeling);
+        SharedLabelingGuard second(ds); // a second labeler must not claim it too
+        CHECK(!second.claimed() && second.observedState() == kSharedLabeling);
+    }
+    CHECK(state() == kSharedFailed);
+
+    // Claimed and completed through a second mapping (the labeler's side): Done
+    ds.header->state.store(kSharedReady);
+    {
+        SharedDataset other;
+        CHECK(openSharedDataset(name, other, &err));
+        if (other.header) {
+            SharedLabelingGuard g(other);
+            CHECK(g.claimed());
+            CHECK(other.count() == 3 && other.points[2][0] == 2.f && other.points[2][1] == -2.f);
+            for (int i = 0; i < 3; ++i) other.results[i] = {0.5f * i, i == 0 ? -1 : i};
+            g.done();
+            CHECK(state() == kSharedDone);
+        }
+        closeSharedDataset(other);
+    }
+    CHECK(state() == kSharedDone);
+    CHECK(ds.results[0].size == 0.f && ds.results[0].corner == -1);
+    CHECK(ds.results[2].size == 1.f && ds.results[2].corner == 2);
+    {
+        SharedLabelingGuard g(ds); // Done is final
+        CHECK(!g.claimed() && g.observedState() == kSharedDone);
+    }
+    CHECK(state() == kSharedDone);
+
+    closeSharedDataset(ds);
+    CHECK(unlinkSharedDataset(name));
+#else
+    SharedDataset ds;
+    std::string err;
+    CHECK(!createSharedDataset("/pg_test", 3, ds, &err) && !err.empty());
+#endif
+    return testResult("test_shared_dataset");
+}
@@ -0,0 +1,176 @@
+// tests/test_threshold_codec.cpp
+// 16-bit threshold codes round down within one log step, sizes below smin and unlabeled points
+// mean "no label", decoded .lq16 layouts stay conflict-free, and corrupt record counts are rejected.
+#include "threshold_codec.hpp"
+#include "zoom_thresholds.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+static void checkCodes() {
+    const float smin = 1e-4f, smax = 250.f;
+    const ThresholdCodec c = makeThresholdCodec(smin, smax);
+    const double step = std::pow((double)smax / smin, 1.0 / 65534.0); // relative code step
+
+    TestRng rng(3);
+    for (int k = 0; k < 20000; ++k) {
+        const float s = (float)(smin * std::pow((double)smax / smin, rng.next()));
+        const uint16_t code = encodeThreshold(c, s);
+        const double d = decodeThreshold(c, code);
+        CHECK_MSG(code >= 1 && d <= s, "s=%g code=%u decoded=%g", s, code, d);
+        CHECK_MSG(d * step * (1.0 + 1e-6) >= s, "s=%g decoded=%g below one step", s, d);
+    }
+    CHECK(encodeThreshold(c, smin) == 1 && decodeThreshold(c, 1) <= smin);
+    CHECK(encodeThreshold(c, smax) == 65535 && decodeThreshold(c, 65535) <= smax);
+    CHECK(encodeThreshold(c, smax * 4.f) == 65535);
+    // Below smin / invalid: no label
+    CHECK(encodeThreshold(c, smin * 0.999f) == 0);
+    CHECK(encodeThreshold(c, 0.f) == 0 && encodeThreshold(c, -1.f) == 0);
+    CHECK(encodeThreshold(c, std::numeric_limits<float>::quiet_NaN()) == 0);
+    CHECK(encodeThreshold(c, std::numeric_limits<float>::infinity()) == 0);
+    CHECK(decodeThreshold(c, 0) == 0.f);
+
+    const uint32_t packed = packLabel(40000, 3);
+    CHECK(labelCode(packed) == 40000 && labelCorner(packed) == 3);
+}
+
+// Clustered points over a wide extent: position steps (extent / 65535) are a visible fraction
+// of the label sizes near the clusters' cores.
+static std::vector<std::array<float,2>> clusteredPoints(int n, uint64_t seed) {
+    TestRng rng(seed);
+    std::vector<std::array<float,2>> pts;
+    for (int i = 0; i < n; ++i) {
+        const double cx = (i % 4) * 300.0, cy = (i % 3) * 250.0;
+        pts.push_back({(float)(cx + rng.next() * 2.0), (float)(cy + rng.next() * 2.0)});
+    }
+    return pts;
+}
+
+struct DRect { double xmin, ymin, xmax, ymax; };
+static DRect labelRect(double x, double y, int corner, double s) {
+    const double xmin = (corner == 1 || corner == 2) ? x : x - s;
+    const double ymin = (corner >= 2) ? y : y - s;
+    return {xmin, ymin, xmin + s, ymin + s};
+}
+
+static void checkDecodedLayout() {
+    const auto pts = clusteredPoints(1500, 5);
+    const float Smin = 1e-4f, Smax = 1000.f;
+    PlacementOptions opts;
+    opts.cornerCellSize = 0.5f; // the 0.05 default is meant for unit-square data
+    const ThresholdResult r = computeZoomThresholdsMonotone(pts, Smin, Smax, 1.2f, 56, 4, opts);
+
+    std::vector<double> xs, ys;
+    for (const auto& p : pts) { xs.push_back(p[0]); ys.push_back(p[1]); }
+    const QuantizedLabelSet set = quantizeLabels(xs, ys, r.size, r.corner, r.labeled, makeThresholdCodec(Smin, Smax));
+    CHECK(set.records.size() == pts.size());
+
+    const double posStep = std::max(set.scaleX, set.scaleY);
+    std::vector<double> qx, qy, t;
+    int labeled = 0;
+    for (size_t i = 0; i < set.records.size(); ++i) {
+        const auto& q = set.records[i];
+        qx.push_back(set.originX + q.qx * set.scaleX);
+        qy.push_back(set.originY + q.qy * set.scaleY);
+        CHECK(std::fabs(qx.back() - xs[i]) <= 0.5 * set.scaleX * (1.0 + 1e-9));
+        CHECK(std::fabs(qy.back() - ys[i]) <= 0.5 * set.scaleY * (1.0 + 1e-9));
+        const uint16_t code = labelCode(q.label);
+        t.push_back(decodeThreshold(set.codec, code));
+        // Size bound: never above the exact threshold minus the position step
+        CHECK_MSG(t.back() <= (double)r.size[i] - posStep || code == 0,
+                  "point %zu: decoded %g, exact %g, step %g", i, t.back(), r.size[i], posStep);
+        if (code) { ++labeled; CHECK(labelCorner(q.label) == r.corner[i]); }
+        else CHECK((double)r.size[i] - posStep < Smin * 1.0001);
+    }
+    CHECK(labeled > 0);
+
+    // Decoded labels drawn at S <= decoded threshold: no overlaps, no covered points
+    const double tol = 1e-9 * 1000.0;
+    for (int k = 0; k <= 30; ++k) {
+        const double S = Smin * std::pow((double)Smax / Smin, k / 30.0);
+        std::vector<int> shown;
+        for (int i = 0; i < (int)t.size(); ++i) if (t[i] > 0.0 && t[i] >= S) shown.push_back(i);
+        int overlaps = 0, covered = 0;
+        for (size_t a = 0; a < shown.size(); ++a) {
+            const DRect A = labelRect(qx[shown[a]], qy[shown[a]], labelCorner(set.records[shown[a]].label), S);
+            for (size_t b = a + 1; b < shown.size(); ++b) {
+                const DRect B = labelRect(qx[shown[b]], qy[shown[b]], labelCorner(set.records[shown[b]].label), S);
+                const double w = std::min(A.xmax, B.xmax) - std::max(A.xmin, B.xmin);
+                const double h = std::min(A.ymax, B.ymax) - std::max(A.ymin, B.ymin);
+                if (w > tol && h > tol) ++overlaps;
+            }
+            for (size_t j = 0; j < qx.size(); ++j) {
+                if ((int)j == shown[a]) continue;
+                if (qx[j] > A.xmin + tol && qx[j] < A.xmax - tol && qy[j] > A.ymin + tol && qy[j] < A.ymax - tol)
+                    ++covered;
+            }
+        }
+        CHECK_MSG(overlaps == 0, "%d overlapping decoded labels at S=%g", overlaps, S);
+        CHECK_MSG(covered == 0, "%d covered decoded points at S=%g", covered, S);
+    }
+}
+
+// Coincident points: no position step lowers the thresholds, so only the labeled flag keeps
+// unlabeled points (size Smin) at code 0, while a point labeled at exactly Smin keeps code 1.
+static void checkUnlabeledCoincident() {
+    const std::vector<double> xs(4, 3.0), ys(4, -2.0);
+    const QuantizedLabelSet set = quantizeLabels(xs, ys, {5.f, 0.01f, 0.01f, 0.01f}, {2, 1, 3, 0},
+                                                 {1, 0, 0, 1}, makeThresholdCodec(0.01f, 10.f));
+    CHECK(set.records.size() == 4);
+    if (set.records.size() != 4) return;
+    CHECK(labelCode(set.records[0].label) > 1 && labelCorner(set.records[0].label) == 2);
+    CHECK(labelCode(set.records[1].label) == 0 && labelCode(set.records[2].label) == 0);
+    CHECK(labelCode(set.records[3].label) == 1);
+    for (const auto& q : set.records) CHECK(set.originX + q.qx * set.scaleX == 3.0 && set.originY + q.qy * set.scaleY == -2.0);
+}
+
+static void checkFiles() {
+    std::vector<double> xs = {0.0, 1.0, 2.5}, ys = {0.0, -1.0, 4.0};
+    const QuantizedLabelSet set = quantizeLabels(xs, ys, {0.5f, 2.f, 0.f}, {0, 1, 2}, {1, 1, 0}, makeThresholdCodec(0.01f, 10.f));
+    const std::string path = "threshold_codec_test.lq16";
+    CHECK(writeQuantizedLabels(path, set));
+
+    QuantizedLabelSet back;
+    std::string err;
+    CHECK(readQuantizedLabels(path, back, &err));
+    CHECK(back.records.size() == 3 && back.originX == set.originX && back.scaleY == set.scaleY);
+    for (size_t i = 0; i < back.records.size() && i < 3; ++i) {
+        CHECK(back.records[i].qx == set.records[i].qx && back.records[i].label == set.records[i].label);
+    }
+
+    // Record count larger than the file: rejected before allocating
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t huge = 1ull << 60;
+        f.seekp(8);
+        f.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    err.clear();
+    CHECK(!readQuantizedLabels(path, back, &err) && back.records.empty());
+    CHECK_MSG(err.find("exceeds") != std::string::npos, "error: %s", err.c_str());
+
+    // Truncated records
+    CHECK(writeQuantizedLabels(path, set));
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), (std::streamsize)bytes.size() - 3);
+    }
+    CHECK(!readQuantizedLabels(path, back, &err));
+    std::remove(path.c_str());
+}
+
+int main() {
+    checkCodes();
+    checkDecodedLayout();
+    checkUnlabeledCoincident();
+    checkFiles();
+    return testResult("test_threshold_codec");
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @file test_util.hpp
+ * @brief Minimal check macros for the regression tests (builds define NDEBUG, so no assert).
+ */
+
+inline int g_testFailures = 0;
+
+/// @brief Record a failure (with location) when `cond` is false; the test keeps running.
+#define CHECK(cond) do { if (!(cond)) { \
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    ++g_testFailures; } } while (0)
+
+/// @brief CHECK with a printf-style context message.
+#define CHECK_MSG(cond, ...) do { if (!(cond)) { \
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+    std::fprintf(stderr, __VA_ARGS__); std::fputc('\n', stderr); \
+    ++g_testFailures; } } while (0)
+
+/// @brief Exit code for main(): 0 when every check passed.
+inline int testResult(const char* name) {
+    if (g_testFailures) std::fprintf(stderr, "%s: %d check(s) failed\n", name, g_testFailures);
+    else std::printf("%s: ok\n", name);
+    return g_testFailures ? 1 : 0;
+}
+
+/// @brief Deterministic LCG in [0, 1) so test inputs are identical on every platform.
+struct TestRng {
+    uint64_t s;
+    explicit TestRng(uint64_t seed) : s(seed) {}
+    double next() {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        return (double)(s >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
@@ -0,0 +1,208 @@
+// tests/test_zoom_thresholds.cpp
+// The monotone sweep's thresholds must describe a valid layout at every size: the labels of
+// all points with threshold >= S, drawn at size S, never overlap and never cover a point.
+// Zoom-out steps on the indices kept in MonotoneState must place exactly what rebuilt indices
+// place, and monotoneZoomOutAddsLabels must predict whether a step adds labels. The search
+// engine's relative tolerance must hold for every point with fewer probes than absolute eps.
+#include "zoom_thresholds.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <set>
+#include <vector>
+
+using Points = std::vector<std::array<float,2>>;
+
+static Points lattice(int n, float spacing) {
+    Points pts;
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x) pts.push_back({x * spacing, y * spacing});
+    return pts;
+}
+
+static Points clustered(int n, int clusters, uint64_t seed) {
+    TestRng rng(seed);
+    std::vector<std::array<double,3>> centers; // x, y, radius
+    for (int c = 0; c < clusters; ++c)
+        centers.push_back({rng.next() * 100.0, rng.next() * 100.0, 0.5 + rng.next() * 4.0});
+    Points pts;
+    for (int i = 0; i < n; ++i) {
+        const auto& c = centers[i % clusters];
+        // Box-Muller
+        const double u = std::max(1e-12, rng.next()), v = rng.next();
+        const double r = c[2] * std::sqrt(-2.0 * std::log(u));
+        pts.push_back({(float)(c[0] + r * std::cos(6.283185307179586 * v)),
+                       (float)(c[1] + r * std::sin(6.283185307179586 * v))});
+    }
+    return pts;
+}
+
+// Label square in double precision (the exact geometry; float rounding of the edges aside)
+struct DRect { double xmin, ymin, xmax, ymax; };
+static DRect labelRect(const std::array<float,2>& p, int corner, double s) {
+    const double xmin = (corner == 1 || corner == 2) ? p[0] : p[0] - s;
+    const double ymin = (corner >= 2) ? p[1] : p[1] - s;
+    return {xmin, ymin, xmin + s, ymin + s};
+}
+
+// Count overlapping label pairs and covered points at size S. Intersections thinner than a
+// few float ulps of the coordinates are edge contacts, not overlaps.
+static void countConflicts(const Points& pts, const ThresholdResult& r, double S,
+                           int& overlaps, int& covered) {
+    double mag = 0.0;
+    for (const auto& p : pts) mag = std::max({mag, (double)std::fabs(p[0]), (double)std::fabs(p[1])});
+    const double tol = 8.0 * FLT_EPSILON * (mag + S);
+
+    std::vector<int> shown;
+    for (int i = 0; i < (int)pts.size(); ++i)
+        if (r.labeled[i] && r.size[i] >= S) shown.push_back(i);
+    std::vector<DRect> rects;
+    for (int i : shown) rects.push_back(labelRect(pts[i], r.corner[i], S));
+
+    std::vector<int> order(rects.size());
+    for (int k = 0; k < (int)order.size(); ++k) order[k] = k;
+    std::sort(order.begin(), order.end(), [&](int a, int b){ return rects[a].xmin < rects[b].xmin; });
+    overlaps = 0;
+    for (size_t a = 0; a < order.size(); ++a) {
+        const DRect& A = rects[order[a]];
+        for (size_t b = a + 1; b < order.size() && rects[order[b]].xmin < A.xmax - tol; ++b) {
+            const DRect& B = rects[order[b]];
+            const double w = std::min(A.xmax, B.xmax) - std::max(A.xmin, B.xmin);
+            const double h = std::min(A.ymax, B.ymax) - std::max(A.ymin, B.ymin);
+            if (w > tol && h > tol) ++overlaps;
+        }
+    }
+    // Points strictly inside another point's label (sorted by x for a sweep)
+    std::vector<int> byX(pts.size());
+    for (int k = 0; k < (int)byX.size(); ++k) byX[k] = k;
+    std::sort(byX.begin(), byX.end(), [&](int a, int b){ return pts[a][0] < pts[b][0]; });
+    covered = 0;
+    for (size_t k = 0; k < shown.size(); ++k) {
+        const DRect& R = rects[k];
+        auto lo = std::lower_bound(byX.begin(), byX.end(), R.xmin + tol,
+                                   [&](int j, double v){ return pts[j][0] < v; });
+        for (auto it = lo; it != byX.end() && pts[*it][0] < R.xmax - tol; ++it) {
+            if (*it == shown[k]) continue;
+            const double y = pts[*it][1];
+            if (y > R.ymin + tol && y < R.ymax - tol) ++covered;
+        }
+    }
+}
+
+static void checkMonotoneLayout(const char* name, const Points& pts) {
+    float minX = pts[0][0], maxX = minX, minY = pts[0][1], maxY = minY;
+    for (const auto& p : pts) {
+        minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]);
+        minY = std::min(minY, p[1]); maxY = std::max(maxY, p[1]);
+    }
+    const float Smax = std::max(maxX - minX, maxY - minY);
+    const float Smin = Smax * 1e-4f;
+    const ThresholdResult r = computeZoomThresholdsMonotone(pts, Smin, Smax, 1.2f, 56, 4, PlacementOptions{});
+    CHECK((int)r.size.size() == (int)pts.size());
+
+    int labeled = 0;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        labeled += r.labeled[i];
+        CHECK_MSG(r.labeled[i] || r.size[i] == Smin, "%s: unlabeled point %zu has threshold %g", name, i, r.size[i]);
+    }
+    CHECK_MSG(labeled > 0, "%s: no point labeled", name);
+
+    // Every threshold (the sizes where the layout changes) plus a geometric grid in between
+    std::set<double> scales(r.size.begin(), r.size.end());
+    for (int k = 0; k <= 40; ++k) scales.insert(Smin * std::pow((double)Smax / Smin, (k + 0.5) / 41.0));
+    // 0.2 / 0.36 / 0.69 x the 40x40 lattice spacing: sizes where labels that dropped out of the
+    // active set and came back used to keep their first threshold and overlap
+    for (double S : {0.2, 0.36, 0.69}) scales.insert(S * Smax / 39.0);
+    for (double S : scales) {
+        int overlaps = 0, covered = 0;
+        countConflicts(pts, r, S, overlaps, covered);
+        CHECK_MSG(overlaps == 0, "%s: %d overlapping label pairs at S=%g", name, overlaps, S);
+        CHECK_MSG(covered == 0, "%s: %d covered points at S=%g", name, covered, S);
+    }
+}
+
+static void checkIncrementalZoomOut(const char* name, const Points& pts, RectIndexKind kind) {
+    PlacementOptions opts;
+    opts.rectIndex = kind;
+    float maxX = pts[0][0], minX = maxX;
+    for (const auto& p : pts) { minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]); }
+    const float Smax = maxX - minX;
+    MonotoneState state;
+    auto cand = generateLabelCandidates(pts, Smax);
+    greedyPlaceMonotone(cand, pts, Smax, &state, opts);
+    for (float S = Smax / 1.3f; S > Smax * 1e-4f; S /= 1.3f) {
+        const size_t before = state.active.size();
+        MonotoneState rebuilt = state; // shares the caches: rebuilt on first use
+        rebuilt.pointIndex.reset();
+        auto candRebuilt = cand;
+        const bool predicted = monotoneZoomOutAddsLabels(pts, S, &state, opts);
+        greedyPlaceMonotone(cand, pts, S, &state, opts);
+        greedyPlaceMonotone(candRebuilt, pts, S, &rebuilt, opts);
+        CHECK_MSG(state.active == rebuilt.active, "%s: incremental and rebuilt placements differ at S=%g", name, S);
+        CHECK_MSG(predicted == (state.active.size() > before), "%s: probe predicted %d at S=%g (added %zu)",
+                  name, (int)predicted, S, state.active.size() - before);
+    }
+}
+
+// Relative tolerance on thresholds spread over four decades: the log-cluster refinement must
+// bound every point by hi/lo <= 1+tol within the default 64 probes, fewer than absolute-eps
+// bisection uses (which stops at that cap).
+static void checkLogRefinement() {
+    Points pts;
+    float ox = 0.f;
+    for (float d : {0.01f, 0.1f, 1.f, 10.f}) { // 10x10 lattices, 200 apart
+        for (const auto& p : lattice(10, d)) pts.push_back({p[0] + ox, p[1]});
+        ox += 200.f;
+    }
+    const float Smin = 1e-4f, Smax = 700.f, tol = 0.05f;
+    PlacementOptions opts;
+    opts.cornerCellSize = 10.f; // the 0.05 default is meant for unit-square data
+    const ThresholdResult rel = computeZoomThresholds(pts, Smin, Smax, Smax * 6e-5f, 1.2f, 56, 64, true, 0, tol, opts);
+    const ThresholdResult abs = computeZoomThresholds(pts, Smin, Smax, Smax * 6e-5f, 1.2f, 56, 64, true, 0, 0.f, opts);
+    CHECK_MSG(rel.refineRuns < abs.refineRuns, "log refinement %d probes, absolute %d", rel.refineRuns, abs.refineRuns);
+    int loose = 0;
+    for (size_t i = 0; i < pts.size(); ++i)
+        if (rel.upper[i] > rel.size[i] * (1.f + tol)) ++loose;
+    CHECK_MSG(loose == 0, "%d thresholds with hi/lo > 1+%g", loose, tol);
+}
+
+// In a 3x3 lattice (spacing 1) the inner points' labels fit at size 1 (edge contact) and
+// conflict at any larger size. With Smin = 1 their thresholds are exactly Smin, and they must
+// still count as labeled (in both engines), without conflicts at Smin.
+static void checkLabeledAtSmin() {
+    const Points pts = lattice(3, 1.0f);
+    const float Smin = 1.f, Smax = 100.f;
+    PlacementOptions opts;
+    opts.cornerCellSize = 1.f;
+    const ThresholdResult results[2] = {
+        computeZoomThresholds(pts, Smin, Smax, 0.01f, 1.2f, 56, 64, true, 0, 0.f, opts),
+        computeZoomThresholdsMonotone(pts, Smin, Smax, 1.2f, 56, 4, opts)};
+    for (const ThresholdResult& r : results) {
+        int atSmin = 0;
+        for (size_t i = 0; i < pts.size(); ++i) atSmin += r.labeled[i] && r.size[i] == Smin;
+        CHECK_MSG(atSmin > 0, "no point labeled at exactly Smin (%d of %zu labeled)",
+                  (int)std::count(r.labeled.begin(), r.labeled.end(), 1), pts.size());
+        int overlaps = 0, covered = 0;
+        countConflicts(pts, r, Smin, overlaps, covered);
+        CHECK_MSG(overlaps == 0 && covered == 0, "labels at Smin: %d overlaps, %d covered", overlaps, covered);
+    }
+}
+
+int main() {
+    checkMonotoneLayout("lattice 40x40", lattice(40, 1.0f));
+    checkMonotoneLayout("lattice 40x40 (offset)", [] {
+        Points p = lattice(40, 0.1f);
+        for (auto& q : p) { q[0] += 3.7f; q[1] -= 1.3f; }
+        return p;
+    }());
+    checkMonotoneLayout("clustered 2000", clustered(2000, 8, 7));
+    checkMonotoneLayout("clustered 3000", clustered(3000, 3, 11));
+    checkLogRefinement();
+    checkLabeledAtSmin();
+    checkIncrementalZoomOut("clustered 2000 grid", clustered(2000, 8, 7), RectIndexKind::Grid);
+    checkIncrementalZoomOut("clustered 2000 quadtree", clustered(2000, 8, 7), RectIndexKind::Quadtree);
+    checkIncrementalZoomOut("lattice 20x20 linear", lattice(20, 1.0f), RectIndexKind::Linear);
+    return testResult("test_zoom_thresholds");
+}
@@ -1,19 +1,44 @@
 #include "greedy_labeler.hpp"
+#include "engine_planner.hpp"
+#include "csv_reader.hpp"
+#include "geo_tiles.hpp"
+#include "threshold_codec.hpp"
+#include "shared_dataset.hpp"
+#include "memory_model.hpp"
+#include "numa_topology.hpp"
+#include "zoom_thresholds.hpp"
 
 #include <cctype>
+#include <climits>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <numeric>
+#include <optional>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSV_LABELER_HAVE_BATCH 1
+#include <dirent.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
 
 // Simple command-line option helper
 struct ArgsConfig {
@@ -23,15 +48,30 @@ struct ArgsConfig {
     float Smax = -1.f; // auto via span if <0
     // Tuned for higher coverage (~70%+) without exploding runtime
     float epsRel = 6e-5f;   // tighter than 1e-4 => finer threshold resolution
+    float tolRel = 0.f;     // >0: log-space refinement, stop when hi/lo <= 1+tolRel
     float growth = 1.2f;   // moderate coarse step; avoids 100s of runs from 1.003f
     int maxGrowth = 56;     // enough to span typical Smax/Smin ratios
     int maxRefine = 64;     // deeper refinement to tighten intervals
     bool multiSample = true;// enable geometric sweep to seed bounds
     int multiSamples = 0;   // auto choose if 0
+    std::string engine = "search"; // "search" (independent probes), "monotone" (descending sweep) or "auto"
+    int refineSteps = 4;    // monotone engine: sub-steps per coarse step that activates labels
+    std::string xCol = "0"; // column specs: header name or 0-based index
+    std::string yCol = "1";
+    std::string weightCol;  // optional; adds a weight column to the output
+    char delimiter = 0;     // 0: detect from the first line
+    std::string project = "none"; // "mercator": x/y are lon/lat degrees, label in Web Mercator meters
+    std::string format = "csv";   // "q16": binary .lq16 (16-bit x/y + packed 16-bit threshold/corner)
+    int threads = 0;              // corner-selection threads; 0: planner's choice (auto) or 1
 };
 
 static void printUsage(){
-    std::cerr << "Usage: csv_labeler <input.csv> <output.csv> [options]\n"
+    std::cerr << "Usage: csv_labeler <input.csv|shm:/name|fd:N> <output.csv|output.lq16|-> [options]\n"
+              << "       csv_labeler --batch <list.txt|dir> <outdir> [options] [--mem-limit 8G] [--jobs n] [--mem-calib f]\n"
+              << "  shm:/name         label points from a shared-memory dataset (shared_dataset.hpp) and\n"
+              << "                    write results back into it; output '-' skips the file\n"
+              << "  fd:N              same, for a segment behind inherited descriptor N (e.g. an anonymous\n"
+              << "                    memfd from createSharedDataset(\"\"); the parent clears FD_CLOEXEC first)\n"
               << "Options:\n"
               << "  --smin v          Minimum size (default 1e-4)\n"
               << "  --smax v          Maximum size (default = span)\n"
@@ -39,151 +79,73 @@ static void printUsage(){
               << "  --max-growth n    Max coarse growth iterations (default 56)\n"
               << "  --max-refine n    Max refinement iterations (default 64)\n"
               << "  --eps-rel r       Relative epsilon factor (default 6e-5)\n"
+              << "  --tol-rel t       Per-point relative tolerance; bisect in log space (default off)\n"
               << "  --multi-sample k  Pre-sample k geometric sizes (0=auto auto)\n"
               << "  --multi           Force enable geometric pre-sampling (default on)\n"
+              << "  --engine e        Threshold engine: search | monotone | auto (default search)\n"
+              << "  --refine-steps k  Monotone engine: sub-steps around activations (default 4)\n"
+              << "  --threads n       Corner-selection threads (default 1; auto: planner's choice)\n"
+              << "  --x-col c         x column, header name or 0-based index (default 0)\n"
+              << "  --y-col c         y column, header name or 0-based index (default 1)\n"
+              << "  --weight-col c    Optional weight column (copied to output)\n"
+              << "  --delim d         Field delimiter: , ; | tab (default detected from the first line)\n"
+              << "  --project p       none | mercator (x/y = lon/lat degrees; sizes in meters)\n"
+              << "  --format f        csv | q16 (binary, 8 bytes/point, log-quantized thresholds)\n"
+              << "Batch (one child process per file, other options are passed through):\n"
+              << "  --mem-limit m     Budget for summed estimated peaks, e.g. 8G / 512M (default 80% of RAM)\n"
+              << "  --jobs n          Max concurrent files (default hardware threads)\n"
+              << "  --mem-calib f     Estimate calibration log (default <outdir>/mem_calibration.csv)\n"
               << std::endl;
 }
 
-// ---------------- Batch / hybrid search for uniform zoom thresholds ----------------
-struct ThresholdResult {
-    std::vector<float> size;
-    std::vector<int> corner;
-    int growthRuns = 0;   // number of greedy runs during growth
-    int refineRuns = 0;   // number of greedy runs during refinement
-    int sweepRuns = 0;    // optional multi-sample passes
-};
-
-// Stateless per-scale test
-static void runAtScale(const std::vector<std::array<float,2>>& pts, float S,
-                       std::vector<unsigned char>& aliveOut,
-                       std::vector<int>& chosenCorner) {
-    auto cand = generateLabelCandidates(pts, S);
-    greedyPlaceOneLabelPerPoint(cand, pts);
-    int N = (int)pts.size();
-    aliveOut.assign(N, 0);
-    chosenCorner.assign(N, -1);
-    for (int i=0;i<N;++i) {
-        for (int c=0;c<4;++c) {
-            const auto &C = cand[i*4 + c];
-            if (C.valid) { aliveOut[i]=1; chosenCorner[i]=C.corner; break; }
-        }
-    }
-}
-
-static ThresholdResult computeZoomThresholds(const std::vector<std::array<float,2>>& pts,
-                                             float Smin, float Smax,
-                                             float eps, float growth,
-                                             int maxGrowth, int maxRefine,
-                                             bool multiSample, int multiSamples) {
-    ThresholdResult r; int N = (int)pts.size();
-    r.size.assign(N, Smin); r.corner.assign(N, 0);
-    if (N == 0) return r;
-
-    struct Interval { float lo, hi; bool resolved; };
-    std::vector<Interval> iv(N, {Smin, Smax, false});
-    std::vector<int> alive(N, 1);
-
-    // Optional geometric sweep pre-pass to densify sampling
-    if (multiSample) {
-        if (multiSamples <= 0) {
-            // choose count so that growth^k ~ Smax/Smin => k ~ log(Smax/Smin)/log(growth)
-            multiSamples = std::max(8, (int)std::ceil(std::log(Smax/Smin)/std::log(growth))); // ensure >=8
-        }
-        float logMin = std::log(Smin);
-        float logMax = std::log(Smax);
-        for (int i=0;i<multiSamples;i++) {
-            float t = (multiSamples==1)?0.f : (float)i/(multiSamples-1);
-            float S = std::exp(logMin + t*(logMax - logMin));
-            std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
-            runAtScale(pts, S, aliveNow, chosenNow);
-            r.sweepRuns++;
-            for (int p=0;p<N;++p) {
-                if (aliveNow[p]) {
-                    if (S > iv[p].lo) { // extend lower bound if bigger
-                        iv[p].lo = S; r.size[p] = S; if (chosenNow[p]>=0) r.corner[p]=chosenNow[p];
-                    }
-                } else {
-                    // shrink hi if first time dead above current lo
-                    if (S < iv[p].hi) iv[p].hi = S;
-                }
-            }
-        }
-        // mark resolved if tight already
-        for (int i=0;i<N;++i) if (iv[i].hi - iv[i].lo <= eps) iv[i].resolved = true;
-    }
-
-    // Growth phase (coarse expansion)
-    float S = (Smin > 0 ? Smin : 1e-4f);
-    for (int g=0; g<maxGrowth && S < Smax; ++g) {
-        std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
-        runAtScale(pts, S, aliveNow, chosenNow);
-        r.growthRuns++;
-        for (int i=0;i<N;++i) {
-            if (aliveNow[i]) {
-                if (S > iv[i].lo) { iv[i].lo = S; r.size[i]=S; if(chosenNow[i]>=0) r.corner[i]=chosenNow[i]; }
-            } else if (alive[i]) { iv[i].hi = S; alive[i]=0; }
-        }
-        bool anyAlive=false; for(int i=0;i<N;++i) if(alive[i]) { anyAlive=true; break; }
-        if(!anyAlive) break;
-        S *= growth; if (S > Smax) S = Smax;
-    }
-    for (int i=0;i<N;++i) if (alive[i]) iv[i].hi = std::min(iv[i].hi, Smax);
-
-    // Refinement (batched median probing)
-    for (int iter=0; iter<maxRefine; ++iter) {
-        std::vector<float> mids; mids.reserve(N);
-        for (int i=0;i<N;++i) if(!iv[i].resolved && iv[i].hi - iv[i].lo > eps) mids.push_back(0.5f*(iv[i].lo+iv[i].hi));
-        if (mids.empty()) break;
-        std::nth_element(mids.begin(), mids.begin()+mids.size()/2, mids.end());
-        float testS = mids[mids.size()/2];
-        std::vector<unsigned char> aliveNow; std::vector<int> chosenNow;
-        runAtScale(pts, testS, aliveNow, chosenNow);
-        r.refineRuns++;
-        bool anyUnresolved=false;
-        for (int i=0;i<N;++i) {
-            if (iv[i].resolved) continue;
-            if (aliveNow[i]) { iv[i].lo = testS; r.size[i]=testS; if(chosenNow[i]>=0) r.corner[i]=chosenNow[i]; }
-            else { iv[i].hi = testS; }
-            if (iv[i].hi - iv[i].lo <= eps) iv[i].resolved = true; else anyUnresolved=true;
-        }
-        if (!anyUnresolved) break;
-    }
-    return r;
-}
-
-static bool read_points_csv(const std::string& path, std::vector<std::array<float,2>>& pts) {
-    std::ifstream in(path);
-    if (!in) { std::cerr << "Failed to open input: " << path << "\n"; return false; }
-    std::string line; bool first = true;
-    while (std::getline(in, line)) {
-        if (line.empty()) continue;
-        if (first) {
-            first = false;
-            bool hasAlpha = false; for (unsigned char c: line) { if (std::isalpha(c)) { hasAlpha = true; break; } }
-            if (hasAlpha) continue; // skip header row
-        }
-        std::replace(line.begin(), line.end(), ';', ',');
-        std::stringstream ss(line);
-        std::string xs, ys; if (!std::getline(ss, xs, ',')) continue; if (!std::getline(ss, ys, ',')) continue;
-        try { float x = std::stof(xs); float y = std::stof(ys); pts.push_back({x,y}); } catch (...) { /* ignore */ }
+static bool read_points_csv(const ArgsConfig& cfg, std::vector<double>& xs, std::vector<double>& ys,
+                            std::vector<float>& weights) {
+    std::string err;
+    CsvOptions csv;
+    csv.delimiter = cfg.delimiter;
+    if (!readPointsCsvColumns(cfg.inPath, cfg.xCol, cfg.yCol, cfg.weightCol, xs, ys, weights, &err, csv)) {
+        std::cerr << err << "\n"; return false;
     }
     return true;
 }
 
 static bool write_results_csv(const std::string& path,
-                              const std::vector<std::array<float,2>>& pts,
-                              const std::vector<LabelCandidate>& cands) {
+                              const std::vector<double>& xs, const std::vector<double>& ys,
+                              const std::vector<LabelCandidate>& cands,
+                              const std::vector<float>& weights) {
     std::ofstream out(path);
     if (!out) { std::cerr << "Failed to write output: " << path << "\n"; return false; }
-    out << "x,y,side,size,corner\n"; // extended header: include corner explicitly last
+    const bool withWeight = !weights.empty();
+    out << "x,y,side,size,corner" << (withWeight ? ",weight\n" : "\n"); // extended header: include corner explicitly last
     const int perPoint = 4;
-    for (int i=0;i<(int)pts.size();++i) {
+    for (int i=0;i<(int)xs.size();++i) {
         int base = i*perPoint; int chosen = 0; float side = std::numeric_limits<float>::infinity(); bool found=false;
         for (int j=0;j<4;++j) { const auto& c = cands[base+j]; if (c.valid) { chosen = c.corner; side = c.size; found=true; break; } }
         if (!found) side = std::numeric_limits<float>::infinity();
-        out << pts[i][0] << "," << pts[i][1] << ",";
+        // input coordinates at full double precision (default 6 digits mangles ~1e7 values)
+        out << std::setprecision(15) << xs[i] << "," << ys[i] << "," << std::setprecision(6);
         if (std::isfinite(side)) out << side; else out << "INF";
-        out << "," << (found?side:0) << "," << chosen << "\n"; // keep size duplicate for compatibility
+        out << "," << (found?side:0) << "," << chosen; // keep size duplicate for compatibility
+        if (withWeight) out << "," << weights[i];
+        out << "\n";
+    }
+    return true;
+}
+
+// Binary output: 16-bit quantized position + 4-byte packed label per point (threshold_codec.hpp).
+// Positions are the labeling coordinates (frame origin + offset, projected meters under
+// --project mercator), the space the thresholds are measured in.
+static bool write_results_q16(const std::string& path, double originX, double originY,
+                              const std::vector<std::array<float,2>>& points,
+                              const ThresholdResult& r, float Smin, float Smax) {
+    std::vector<double> xs(points.size()), ys(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        xs[i] = originX + points[i][0];
+        ys[i] = originY + points[i][1];
+    }
+    const ThresholdCodec codec = makeThresholdCodec(Smin, Smax);
+    if (!writeQuantizedLabels(path, quantizeLabels(xs, ys, r.size, r.corner, r.labeled, codec))) {
+        std::cerr << "Failed to write output: " << path << "\n"; return false;
     }
     return true;
 }
@@ -200,22 +162,341 @@ static ArgsConfig parseArgs(int argc, char** argv) {
         else if (a == "--max-growth" && need(i)) { cfg.maxGrowth = std::stoi(argv[++i]); }
         else if (a == "--max-refine" && need(i)) { cfg.maxRefine = std::stoi(argv[++i]); }
         else if (a == "--eps-rel" && need(i)) { cfg.epsRel = std::stof(argv[++i]); }
+        else if (a == "--tol-rel" && need(i)) { cfg.tolRel = std::stof(argv[++i]); }
         else if (a == "--multi-sample" && need(i)) { cfg.multiSamples = std::stoi(argv[++i]); cfg.multiSample = true; }
         else if (a == "--multi") { cfg.multiSample = true; }
+        else if (a == "--engine" && need(i)) { cfg.engine = argv[++i]; }
+        else if (a == "--refine-steps" && need(i)) { cfg.refineSteps = std::stoi(argv[++i]); }
+        else if (a == "--threads" && need(i)) { cfg.threads = std::max(1, std::stoi(argv[++i])); }
+        else if (a == "--x-col" && need(i)) { cfg.xCol = argv[++i]; }
+        else if (a == "--y-col" && need(i)) { cfg.yCol = argv[++i]; }
+        else if (a == "--weight-col" && need(i)) { cfg.weightCol = argv[++i]; }
+        else if (a == "--delim" && need(i)) {
+            if (!parseCsvDelimiter(argv[++i], cfg.delimiter)) std::cerr << "Ignoring invalid --delim " << argv[i] << "\n";
+        }
+        else if (a == "--project" && need(i)) { cfg.project = argv[++i]; }
+        else if (a == "--format" && need(i)) { cfg.format = argv[++i]; }
         else if (a == "--help" || a == "-h") { printUsage(); }
     }
     return cfg;
 }
 
+// ---------------- Batch mode: memory-aware admission of one child process per file ----------------
+#if CSV_LABELER_HAVE_BATCH
+struct BatchJob {
+    std::string in, out, log;
+    size_t rows = 0;
+    bool exactRows = false;     // rows counted (or sampled file read whole), not scaled from its size
+    int threads = 1;            // corner-selection threads the job will use
+    uint64_t rawEstimate = 0;   // memory_model estimate (what the calibration log compares against)
+    uint64_t estimate = 0;      // calibrated estimate used for admission
+};
+
+// Row estimates from a sample may be this far below the true count before admission cares
+static constexpr double kRowSampleSlack = 1.25;
+
+// Point count a job reported in its log ("Points: N ..."), 0 if missing
+static size_t loggedPointCount(const std::string& log) {
+    std::ifstream in(log);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 8, "Points: ") == 0) return (size_t)std::strtoull(line.c_str() + 8, nullptr, 10);
+    }
+    return 0;
+}
+
+// "8G", "512M", "64k" or plain bytes
+static uint64_t parseByteSize(const std::string& s) {
+    if (s.empty()) return 0;
+    char* end = nullptr;
+    const double v = std::strtod(s.c_str(), &end);
+    double mul = 1.0;
+    switch (std::tolower((unsigned char)*end)) {
+        case 'k': mul = 1024.0; break;
+        case 'm': mul = 1024.0 * 1024.0; break;
+        case 'g': mul = 1024.0 * 1024.0 * 1024.0; break;
+        case 't': mul = 1024.0 * 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+    }
+    return v > 0.0 ? (uint64_t)(v * mul) : 0;
+}
+
+static std::vector<std::string> listBatchInputs(const std::string& path) {
+    std::vector<std::string> files;
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* e = readdir(dir)) {
+            const std::string name = e->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) files.push_back(path + "/" + name);
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty() && line[0] != '#') files.push_back(line);
+    }
+    return files;
+}
+
+static std::string fileStem(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+static int runBatch(int argc, char** argv) {
+    if (argc < 4) { printUsage(); return 2; }
+    const std::string listPath = argv[2], outDir = argv[3];
+    uint64_t memLimit = 0;
+    int maxJobs = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::string calibPath = outDir + "/mem_calibration.csv";
+    std::string engine = "search", format = "csv";
+    std::vector<std::string> specs = {"0", "1", ""}; // x, y, weight: header detection as the jobs do it
+    CsvOptions csv;
+    int threads = 0;
+    std::vector<std::string> passthrough;
+    for (int i = 4; i < argc; ++i) {
+        const std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--mem-limit" && hasValue) memLimit = parseByteSize(argv[++i]);
+        else if (a == "--jobs" && hasValue) maxJobs = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--mem-calib" && hasValue) calibPath = argv[++i];
+        else {
+            if (a == "--engine" && hasValue) engine = argv[i + 1];
+            if (a == "--format" && hasValue) format = argv[i + 1];
+            if (a == "--x-col" && hasValue) specs[0] = argv[i + 1];
+            if (a == "--y-col" && hasValue) specs[1] = argv[i + 1];
+            if (a == "--weight-col" && hasValue) specs[2] = argv[i + 1];
+            if (a == "--delim" && hasValue) parseCsvDelimiter(argv[i + 1], csv.delimiter);
+            if (a == "--threads" && hasValue) threads = std::max(1, std::atoi(argv[i + 1]));
+            passthrough.push_back(a);
+        }
+    }
+    if (memLimit == 0) {
+        const long pages = sysconf(_SC_PHYS_PAGES), pageSize = sysconf(_SC_PAGE_SIZE);
+        memLimit = (pages > 0 && pageSize > 0) ? (uint64_t)pages * (uint64_t)pageSize / 10 * 8 : (uint64_t(4) << 30);
+    }
+
+    // Model inputs: threads as each job will run them (--threads, else the planner's choice for
+    // auto), NUMA nodes of this machine, calibration of runs with the same engine and threads
+    const int numaNodes = numaTopology().nodeCount();
+    const bool weighted = !specs[2].empty();
+    auto threadsFor = [&](size_t rows) { return threads > 0 ? threads : engine == "auto" ? plannedCornerThreads(rows) : 1; };
+    std::map<int, MemoryCalibration> calibrations;
+    auto calibrationFor = [&](int t) -> const MemoryCalibration& {
+        auto it = calibrations.find(t);
+        if (it == calibrations.end()) it = calibrations.emplace(t, loadMemoryCalibration(calibPath, engine, t)).first;
+        return it->second;
+    };
+    auto estimateJob = [&](BatchJob& j) {
+        j.threads = threadsFor(j.rows);
+        j.rawEstimate = estimatePeakBytes(j.rows, engine, j.threads, numaNodes, weighted);
+        j.estimate = (uint64_t)((double)j.rawEstimate * calibrationFor(j.threads).ratio);
+    };
+
+    // Estimate every file from its size and first rows; count rows (a full read of each file)
+    // only when the sampled estimates, allowing for row-length drift, do not all fit the budget
+    std::vector<BatchJob> jobs;
+    uint64_t slackSum = 0;
+    for (const auto& in : listBatchInputs(listPath)) {
+        BatchJob j;
+        j.in = in;
+        j.out = outDir + "/" + fileStem(in) + (format == "q16" ? ".lq16" : "_labels.csv");
+        j.log = outDir + "/" + fileStem(in) + ".log";
+        const CsvRowEstimate rows = estimateCsvRows(in, specs, csv);
+        j.rows = rows.rows;
+        j.exactRows = rows.exact;
+        estimateJob(j);
+        slackSum += j.exactRows ? j.estimate : (uint64_t)((double)j.estimate * kRowSampleSlack);
+        jobs.push_back(j);
+    }
+    if (jobs.empty()) { std::cerr << "No batch inputs in " << listPath << "\n"; return 4; }
+    int counted = 0;
+    if (slackSum > memLimit) {
+        for (auto& j : jobs) {
+            if (j.exactRows) continue;
+            j.rows = countCsvRows(j.in, specs, csv);
+            j.exactRows = true;
+            estimateJob(j);
+            ++counted;
+        }
+    }
+    const MemoryCalibration& cal = calibrationFor(threadsFor(0));
+    std::cout << "Batch: files=" << jobs.size() << " memLimit(MB)=" << memLimit / (1 << 20)
+              << " jobs=" << maxJobs << " rowsCounted=" << counted << " numaNodes=" << numaNodes
+              << " calibration ratio=" << cal.ratio << " (" << cal.samples << " samples";
+    for (const auto& c : calibrations)
+        if (c.first != threadsFor(0)) std::cout << "; " << c.first << " threads: " << c.second.ratio << " x " << c.second.samples;
+    std::cout << ")\n";
+
+    std::string self = argv[0];
+#if defined(__linux__)
+    if (access("/proc/self/exe", X_OK) == 0) self = "/proc/self/exe";
+#endif
+    auto spawnJob = [&](const BatchJob& j) -> pid_t {
+        std::vector<std::string> args = {self, j.in, j.out};
+        args.insert(args.end(), passthrough.begin(), passthrough.end());
+        std::vector<char*> cargs;
+        for (auto& a : args) cargs.push_back(&a[0]);
+        cargs.push_back(nullptr);
+        posix_spawn_file_actions_t fa;
+        posix_spawn_file_actions_init(&fa);
+        posix_spawn_file_actions_addopen(&fa, 1, j.log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        posix_spawn_file_actions_adddup2(&fa, 1, 2);
+        pid_t pid = -1;
+        const int rc = posix_spawn(&pid, self.c_str(), &fa, nullptr, cargs.data(), environ);
+        posix_spawn_file_actions_destroy(&fa);
+        return rc == 0 ? pid : -1;
+    };
+
+    // Largest-first: admit the biggest pending file that still fits the budget, so small files
+    // fill the gaps next to big ones; a file larger than the whole budget runs alone.
+    std::vector<size_t> pending(jobs.size());
+    std::iota(pending.begin(), pending.end(), size_t(0));
+    std::sort(pending.begin(), pending.end(), [&](size_t a, size_t b){ return jobs[a].estimate > jobs[b].estimate; });
+    std::unordered_map<pid_t, size_t> running;
+    uint64_t inUse = 0, peakInUse = 0;
+    int failed = 0;
+    size_t peakRunning = 0;
+    auto tStart = std::chrono::high_resolution_clock::now();
+
+    while (!pending.empty() || !running.empty()) {
+        std::vector<uint64_t> pendingEstimates;
+        for (;;) {
+            pendingEstimates.clear();
+            for (size_t k : pending) pendingEstimates.push_back(jobs[k].estimate);
+            const long next = nextBatchJob(pendingEstimates, inUse, running.size(), maxJobs, memLimit);
+            if (next < 0) break;                       // at --jobs, or waiting for memory to free up
+            const size_t k = pending[(size_t)next];
+            pending.erase(pending.begin() + next);
+            if (jobs[k].estimate > memLimit)
+                std::cerr << "Warning: " << jobs[k].in << " estimated " << jobs[k].estimate / (1 << 20)
+                          << " MB exceeds --mem-limit; running it alone\n";
+            const pid_t pid = spawnJob(jobs[k]);
+            if (pid < 0) { std::cerr << "Failed to start job for " << jobs[k].in << "\n"; ++failed; continue; }
+            running[pid] = k;
+            inUse += jobs[k].estimate;
+            peakInUse = std::max(peakInUse, inUse);
+            peakRunning = std::max(peakRunning, running.size());
+        }
+        if (running.empty()) break;
+
+        int status = 0;
+        struct rusage ru;
+        const pid_t pid = wait4(-1, &status, 0, &ru);
+        if (pid < 0) break;
+        auto r = running.find(pid);
+        if (r == running.end()) continue;
+        const BatchJob& j = jobs[r->second];
+        running.erase(r);
+        inUse -= j.estimate;
+#if defined(__APPLE__)
+        const uint64_t peakRss = (uint64_t)ru.ru_maxrss;          // bytes
+#else
+        const uint64_t peakRss = (uint64_t)ru.ru_maxrss * 1024;   // kilobytes
+#endif
+        const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!ok) ++failed;
+        // Calibrate against the points the job actually loaded (the row estimate may be sampled)
+        const size_t points = ok ? loggedPointCount(j.log) : 0;
+        const int jobThreads = points ? threadsFor(points) : j.threads;
+        const uint64_t modeled = points ? estimatePeakBytes(points, engine, jobThreads, numaNodes, weighted) : j.rawEstimate;
+        if (ok && points) appendMemoryCalibration(calibPath, points, modeled, peakRss, engine, jobThreads);
+        std::cout << (ok ? "[done] " : "[fail] ") << j.in << " rows=" << j.rows << (j.exactRows ? "" : "~")
+                  << " points=" << points << " threads=" << jobThreads
+                  << " est(MB)=" << j.estimate / double(1 << 20)
+                  << " peakRSS(MB)=" << peakRss / double(1 << 20)
+                  << " ratio=" << (modeled ? double(peakRss) / double(modeled) : 0.0)
+                  << (ok ? "" : " (see " + j.log + ")") << "\n";
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    std::cout << "Batch: done=" << (jobs.size() - failed) << "/" << jobs.size()
+              << " peakConcurrent=" << peakRunning
+              << " peakEstimated(MB)=" << peakInUse / (1 << 20)
+              << " total(ms)=" << ms << "\n";
+    return failed ? 1 : 0;
+}
+#else
+static int runBatch(int, char**) {
+    std::cerr << "--batch needs a POSIX platform (posix_spawn / wait4)\n";
+    return 2;
+}
+#endif
+
 int main(int argc, char** argv) {
     std::ios::sync_with_stdio(false);
     std::cout.setf(std::ios::unitbuf);
+    if (argc > 1 && std::string(argv[1]) == "--batch") return runBatch(argc, argv);
     if (argc < 3) { printUsage(); return 2; }
     auto cfg = parseArgs(argc, argv);
     if (cfg.inPath.empty()) { printUsage(); return 2; }
+    if (cfg.engine != "search" && cfg.engine != "monotone" && cfg.engine != "auto") {
+        std::cerr << "Unknown engine: " << cfg.engine << "\n"; printUsage(); return 2;
+    }
+    if (cfg.project != "none" && cfg.project != "mercator") {
+        std::cerr << "Unknown projection: " << cfg.project << "\n"; printUsage(); return 2;
+    }
+    if (cfg.format != "csv" && cfg.format != "q16") {
+        std::cerr << "Unknown format: " << cfg.format << "\n"; printUsage(); return 2;
+    }
+
+    std::vector<double> xs, ys; std::vector<float> weights;
+    std::vector<std::array<float,2>> points;
+    double originX = 0.0, originY = 0.0;
+
+    // Shared-memory input: points come from the segment (already float32 in the client's frame)
+    const bool shmInput = cfg.inPath.rfind("shm:", 0) == 0 || cfg.inPath.rfind("fd:", 0) == 0;
+    SharedDataset shm;
+    std::optional<SharedLabelingGuard> shmClaim; // Failed on every exit that does not publish Done
+    if (shmInput) {
+        if (cfg.project != "none" || !cfg.weightCol.empty()) {
+            std::cerr << "--project / --weight-col do not apply to shared-memory input\n"; return 2;
+        }
+        std::string err;
+        bool opened = false;
+        if (cfg.inPath[0] == 's') {
+            opened = openSharedDataset(cfg.inPath.substr(4), shm, &err);
+        } else {
+            const char* digits = cfg.inPath.c_str() + 3;
+            char* end = nullptr;
+            const long fd = std::strtol(digits, &end, 10);
+            if (end == digits || *end || fd < 0 || fd > INT_MAX) { std::cerr << "Invalid descriptor: " << cfg.inPath << "\n"; return 2; }
+            opened = openSharedDatasetFd((int)fd, shm, &err);
+        }
+        if (!opened) { std::cerr << err << "\n"; return 3; }
+        shmClaim.emplace(shm);
+        if (!shmClaim->claimed()) {
+            std::cerr << "Shared dataset is not ready (state " << shmClaim->observedState() << ")\n";
+            shmClaim.reset(); closeSharedDataset(shm); return 3;
+        }
+        // One copy into the working array (the engines take std::vector); results go back in place
+        points.assign(shm.points, shm.points + shm.count());
+        if (points.empty()) { std::cerr << "No points loaded.\n"; return 4; }
+        if (cfg.outPath != "-") {
+            xs.reserve(points.size()); ys.reserve(points.size());
+            for (const auto& p : points) { xs.push_back(p[0]); ys.push_back(p[1]); }
+        }
+    } else {
+        if(!read_points_csv(cfg, xs, ys, weights)){ return 3; }
+        if (xs.empty()) { std::cerr << "No points loaded.\n"; return 4; }
 
-    std::vector<std::array<float,2>> points; if(!read_points_csv(cfg.inPath, points)){ return 3; }
-    if (points.empty()) { std::cerr << "No points loaded.\n"; return 4; }
+        // Label in float32 offsets from a double origin at the extent center, so large projected
+        // coordinates (e.g. Mercator ~1e7 m) keep their precision; output keeps input coordinates.
+        {
+            std::vector<double> px, py;
+            if (cfg.project == "mercator") {
+                px = xs; py = ys;
+                projectLonLatToMercator(px.data(), py.data(), px.size());
+            }
+            LocalFrame frame = cfg.project == "mercator" ? buildLocalFrame(px, py) : buildLocalFrame(xs, ys);
+            originX = frame.originX; originY = frame.originY;
+            points = std::move(frame.offsets);
+        }
+    }
 
     float minX=points[0][0], maxX=minX, minY=points[0][1], maxY=minY;
     for(auto &p:points){ if(p[0]<minX)minX=p[0]; if(p[0]>maxX)maxX=p[0]; if(p[1]<minY)minY=p[1]; if(p[1]>maxY)maxY=p[1]; }
@@ -227,26 +508,55 @@ int main(int argc, char** argv) {
 
     std::cout << "Points: " << points.size() << " span="<<span
               << " Smin="<<Smin<<" Smax="<<Smax<<" eps="<<eps<<"\n";
+    std::cout << "Frame: origin=(" << std::setprecision(15) << originX << "," << originY
+              << std::setprecision(6) << ") projection=" << cfg.project << "\n";
     std::cout << "Params: growth="<<cfg.growth<<" maxGrowth="<<cfg.maxGrowth
               << " maxRefine="<<cfg.maxRefine
               << (cfg.multiSample?" multiSample=on":" multiSample=off")
               << " epsRel="<<cfg.epsRel
+              << " tolRel="<<cfg.tolRel
+              << " engine="<<cfg.engine
               << "\n";
 
     auto tStart = std::chrono::high_resolution_clock::now();
-    auto thresholds = computeZoomThresholds(points, Smin, Smax, eps,
-                                            cfg.growth, cfg.maxGrowth, cfg.maxRefine,
-                                            cfg.multiSample, cfg.multiSamples);
+    PlacementOptions placement;
+    std::string engine = cfg.engine;
+    if (engine == "auto") {
+        auto tPlan = std::chrono::high_resolution_clock::now();
+        EnginePlan plan = planEngine(points);
+        double planMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tPlan).count();
+        placement = plan.placement;
+        engine = toString(plan.engine);
+        std::cout << "Plan: engine="<<engine
+                  << " index="<<toString(placement.rectIndex)
+                  << " corners="<<toString(placement.corners)
+                  << " cornerCell="<<placement.cornerCellSize
+                  << " threads="<<placement.threads
+                  << " (ms)="<<planMs << "\n";
+        std::cout << "Plan stats: sampled="<<plan.stats.sampled
+                  << " extent=["<<plan.stats.minX<<","<<plan.stats.maxX<<"]x["<<plan.stats.minY<<","<<plan.stats.maxY<<"]"
+                  << " skew="<<plan.stats.occupancySkew
+                  << " duplicates="<<plan.stats.duplicateRate << "\n";
+        for (const auto& why : plan.reasons) std::cout << "Plan reason: " << why << "\n";
+    }
+    if (cfg.threads > 0) placement.threads = cfg.threads;
+    ParallelStats parallelStats;
+    placement.stats = &parallelStats;
+    auto thresholds = (engine == "monotone")
+        ? computeZoomThresholdsMonotone(points, Smin, Smax, cfg.growth, cfg.maxGrowth, cfg.refineSteps, placement)
+        : computeZoomThresholds(points, Smin, Smax, eps,
+                                cfg.growth, cfg.maxGrowth, cfg.maxRefine,
+                                cfg.multiSample, cfg.multiSamples, cfg.tolRel, placement);
     auto tEnd = std::chrono::high_resolution_clock::now();
     double ms = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
 
-    // Build candidates for output
+    // Build candidates for output (none valid for points that were never labeled)
     auto candidates = generateLabelCandidates(points, 0.0f);
     for (int i=0;i<(int)points.size();++i) {
         int chosen = thresholds.corner[i];
         for (int c=0;c<4;++c) {
             auto &cand = candidates[i*4 + c];
-            cand.valid = (c==chosen);
+            cand.valid = thresholds.labeled[i] && (c==chosen);
             if (cand.valid) { cand.corner = chosen; cand.size = thresholds.size[i]; }
         }
     }
@@ -255,8 +565,30 @@ int main(int argc, char** argv) {
               << " growth="<<thresholds.growthRuns
               << " refine="<<thresholds.refineRuns
               << " total(ms)="<<ms << "\n";
+    if (parallelStats.runs > 0) {
+        const auto& ps = parallelStats;
+        std::cout << "Parallel: runs="<<ps.runs
+                  << " numaNodes="<<ps.numaNodes
+                  << " threads="<<ps.threads
+                  << " pinned="<<ps.pinnedThreads
+                  << " local="<<(ps.items ? 100.0*double(ps.localItems)/double(ps.items) : 100.0)<<"%"
+                  << " replicaMB="<<ps.replicaBytes/1e6
+                  << " haloMisses="<<ps.haloMisses << "\n";
+    }
 
-    write_results_csv(cfg.outPath, points, candidates);
+    if (shmInput) {
+        // Results go straight into the segment's output region, then publish Done
+        for (size_t i = 0; i < points.size(); ++i) {
+            const bool labeled = thresholds.labeled[i];
+            shm.results[i] = {labeled ? thresholds.size[i] : 0.f, labeled ? thresholds.corner[i] : -1};
+        }
+        shmClaim->done();
+        shmClaim.reset();
+        closeSharedDataset(shm);
+    }
+    if (cfg.outPath == "-") {}
+    else if (cfg.format == "q16") write_results_q16(cfg.outPath, originX, originY, points, thresholds, Smin, Smax);
+    else write_results_csv(cfg.outPath, xs, ys, candidates, weights);
     // Coverage metric (percentage of points that received a valid finite label)
     size_t labeled=0; for(size_t i=0;i<points.size();++i){
         bool any=false; for(int c=0;c<4;++c){ if(candidates[i*4+c].valid && std::isfinite(candidates[i*4+c].size)){ any=true; break; } }
@@ -264,6 +596,7 @@ int main(int argc, char** argv) {
     }
     double coveragePct = points.empty()?0.0:100.0*double(labeled)/double(points.size());
     std::cout << "Coverage: "<<labeled<<"/"<<points.size()<<" = "<<coveragePct<<"%\n";
-    std::cout << "Wrote "<<cfg.outPath<<"\n";
+    if (shmInput) std::cout << "Wrote results to "<<cfg.inPath<<"\n";
+    if (cfg.outPath != "-") std::cout << "Wrote "<<cfg.outPath<<"\n";
     return 0;
 }
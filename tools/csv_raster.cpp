@@ -0,0 +1,408 @@
+#include "greedy_labeler.hpp"
+#include "csv_reader.hpp"
+#include "geo_tiles.hpp"
+#include "threshold_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless thumbnails: rasterize points + label outlines from csv_labeler output into a PNG.
+
+struct ArgsConfig {
+    std::string inPath;
+    std::string outPath;
+    float size = 0.f;       // draw labels with threshold >= size at side `size`; 0: median labeled threshold
+    int width = 1024;
+    int height = 0;         // 0: from the data aspect ratio
+    int threads = 0;        // 0: hardware concurrency
+    int pointPx = 3;        // point marker edge in pixels (0 = no points)
+    std::string xCol = "x"; // column specs: header name or 0-based index
+    std::string yCol = "y";
+    std::string sideCol = "side";
+    std::string cornerCol = "corner";
+    char delimiter = 0;     // 0: detect from the first line
+    std::string project = "none"; // must match the csv_labeler run (sizes in Mercator meters)
+};
+
+static void printUsage(){
+    std::cerr << "Usage: csv_raster <labels.csv|labels.lq16> <out.png> [options]\n"
+              << "Options:\n"
+              << "  --size S          Zoom level to render: labels with threshold >= S, at side S\n"
+              << "                    (default the median threshold of the labeled points)\n"
+              << "  --width W         Image width in pixels (default 1024)\n"
+              << "  --height H        Image height in pixels (default from data aspect)\n"
+              << "  --threads T       Raster threads (default hardware concurrency)\n"
+              << "  --point-px p      Point marker size in pixels, 0 = off (default 3)\n"
+              << "  --x-col c         x column, header name or 0-based index (default x)\n"
+              << "  --y-col c         y column (default y)\n"
+              << "  --side-col c      label side column (default side)\n"
+              << "  --corner-col c    corner column (default corner)\n"
+              << "  --delim d         Field delimiter: , ; | tab (default detected)\n"
+              << "  --project p       none | mercator (as passed to csv_labeler; not applied to .lq16)\n"
+              << std::endl;
+}
+
+static ArgsConfig parseArgs(int argc, char** argv) {
+    ArgsConfig cfg; if (argc < 3) return cfg;
+    cfg.inPath = argv[1]; cfg.outPath = argv[2];
+    for (int i=3;i<argc;++i) {
+        std::string a = argv[i];
+        auto need = [&](int &i){ if(i+1>=argc){ std::cerr<<"Missing value after "<<a<<"\n"; return false;} return true; };
+        if (a == "--size" && need(i)) { cfg.size = std::stof(argv[++i]); }
+        else if (a == "--width" && need(i)) { cfg.width = std::stoi(argv[++i]); }
+        else if (a == "--height" && need(i)) { cfg.height = std::stoi(argv[++i]); }
+        else if (a == "--threads" && need(i)) { cfg.threads = std::stoi(argv[++i]); }
+        else if (a == "--point-px" && need(i)) { cfg.pointPx = std::stoi(argv[++i]); }
+        else if (a == "--x-col" && need(i)) { cfg.xCol = argv[++i]; }
+        else if (a == "--y-col" && need(i)) { cfg.yCol = argv[++i]; }
+        else if (a == "--side-col" && need(i)) { cfg.sideCol = argv[++i]; }
+        else if (a == "--corner-col" && need(i)) { cfg.cornerCol = argv[++i]; }
+        else if (a == "--delim" && need(i)) {
+            if (!parseCsvDelimiter(argv[++i], cfg.delimiter)) std::cerr << "Ignoring invalid --delim " << argv[i] << "\n";
+        }
+        else if (a == "--project" && need(i)) { cfg.project = argv[++i]; }
+        else if (a == "--help" || a == "-h") { printUsage(); }
+    }
+    return cfg;
+}
+
+// ---------------- Input ----------------
+static bool isLq16(const std::string& p) {
+    return p.size() > 5 && p.compare(p.size() - 5, 5, ".lq16") == 0;
+}
+
+// x/y in input units (.lq16: labeling units, already projected), side (non-finite / <= 0 = no
+// label) and corner per point. csv_labeler writes INF for points that never get a label, so
+// those rows are skipped even though their threshold is Smin.
+static bool readLabels(const ArgsConfig& cfg, std::vector<double>& xs, std::vector<double>& ys,
+                       std::vector<float>& side, std::vector<int>& corner) {
+    std::string err;
+    const std::string& p = cfg.inPath;
+    if (isLq16(p)) {
+        QuantizedLabelSet set;
+        if (!readQuantizedLabels(p, set, &err)) { std::cerr << err << "\n"; return false; }
+        for (const auto& r : set.records) {
+            xs.push_back(set.originX + r.qx * set.scaleX);
+            ys.push_back(set.originY + r.qy * set.scaleY);
+            side.push_back(decodeThreshold(set.codec, labelCode(r.label))); // 0 = no label
+            corner.push_back(labelCorner(r.label));
+        }
+        return true;
+    }
+    CsvOptions csv;
+    csv.delimiter = cfg.delimiter;
+    const bool ok = forEachCsvRow(p, {cfg.xCol, cfg.yCol, cfg.sideCol, cfg.cornerCol},
+        [&](const std::vector<CsvField>& f) {
+            double x, y;
+            if (!parseDoubleField(f[0], x) || !parseDoubleField(f[1], y)) return;
+            float s = 0.f, c = 0.f;
+            if (!parseFloatField(f[2], s) || !std::isfinite(s)) s = 0.f; // "INF" = no label
+            if (!parseFloatField(f[3], c)) c = 0.f;
+            xs.push_back(x); ys.push_back(y);
+            side.push_back(s); corner.push_back((int)c & 3);
+        }, &err, csv);
+    if (!ok) std::cerr << err << "\n";
+    return ok;
+}
+
+// ---------------- PNG (fixed-Huffman deflate, no external zlib) ----------------
+static uint32_t crc32Update(uint32_t crc, const unsigned char* d, size_t n) {
+    static uint32_t table[256];
+    static bool init = false;
+    if (!init) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            table[i] = c;
+        }
+        init = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ d[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t adler32(const unsigned char* d, size_t n) {
+    uint32_t a = 1, b = 0;
+    while (n > 0) {
+        const size_t blk = std::min<size_t>(n, 5552); // largest run without 32-bit overflow
+        for (size_t i = 0; i < blk; ++i) { a += d[i]; b += a; }
+        a %= 65521; b %= 65521;
+        d += blk; n -= blk;
+    }
+    return (b << 16) | a;
+}
+
+struct BitWriter {
+    std::vector<unsigned char> out;
+    uint32_t acc = 0; int nbits = 0;
+    void bits(uint32_t v, int n) {            // LSB-first (extra bits, headers)
+        acc |= v << nbits; nbits += n;
+        while (nbits >= 8) { out.push_back((unsigned char)acc); acc >>= 8; nbits -= 8; }
+    }
+    void code(uint32_t c, int n) {            // Huffman codes are stored MSB-first
+        uint32_t r = 0;
+        for (int i = 0; i < n; ++i) r |= ((c >> i) & 1u) << (n - 1 - i);
+        bits(r, n);
+    }
+    void flush() { if (nbits > 0) bits(0, 8 - nbits); }
+};
+
+static void fixedLiteral(BitWriter& bw, int sym) {
+    if (sym < 144)      bw.code(0x30 + sym, 8);
+    else if (sym < 256) bw.code(0x190 + (sym - 144), 9);
+    else if (sym < 280) bw.code(sym - 256, 7);
+    else                bw.code(0xC0 + (sym - 280), 8);
+}
+
+// Single fixed-Huffman block; matches only at distance 1 and 3 (same byte / same RGB pixel),
+// which is where thumbnails (flat background, straight outlines) compress
+static std::vector<unsigned char> deflateFixed(const std::vector<unsigned char>& d) {
+    static const int kLenBase[29]  = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+    static const int kLenExtra[29] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+    BitWriter bw;
+    bw.out.push_back(0x78); bw.out.push_back(0x01); // zlib header (no preset dictionary)
+    bw.bits(1, 1); bw.bits(1, 2);                   // BFINAL, BTYPE = fixed Huffman
+    const size_t n = d.size();
+    size_t i = 0;
+    while (i < n) {
+        int bestLen = 0, bestDist = 0;
+        for (int dist : {1, 3}) {
+            if (i < (size_t)dist) continue;
+            int len = 0;
+            while (len < 258 && i + len < n && d[i + len] == d[i + len - dist]) ++len;
+            if (len > bestLen) { bestLen = len; bestDist = dist; }
+        }
+        if (bestLen < 3) { fixedLiteral(bw, d[i]); ++i; continue; }
+        int k = 28;
+        while (kLenBase[k] > bestLen) --k;
+        fixedLiteral(bw, 257 + k);
+        if (kLenExtra[k]) bw.bits((uint32_t)(bestLen - kLenBase[k]), kLenExtra[k]);
+        bw.code((uint32_t)(bestDist - 1), 5);       // distance codes 0 (1) and 2 (3), no extra bits
+        i += (size_t)bestLen;
+    }
+    fixedLiteral(bw, 256);
+    bw.flush();
+    const uint32_t ad = adler32(d.data(), d.size());
+    for (int s = 24; s >= 0; s -= 8) bw.out.push_back((unsigned char)(ad >> s));
+    return std::move(bw.out);
+}
+
+static void writeChunk(std::ofstream& out, const char* type, const std::vector<unsigned char>& data) {
+    const uint32_t n = (uint32_t)data.size();
+    const unsigned char len[4] = {(unsigned char)(n >> 24), (unsigned char)(n >> 16), (unsigned char)(n >> 8), (unsigned char)n};
+    out.write((const char*)len, 4);
+    out.write(type, 4);
+    out.write((const char*)data.data(), (std::streamsize)data.size());
+    uint32_t crc = crc32Update(0, (const unsigned char*)type, 4);
+    crc = crc32Update(crc, data.data(), data.size());
+    const unsigned char c[4] = {(unsigned char)(crc >> 24), (unsigned char)(crc >> 16), (unsigned char)(crc >> 8), (unsigned char)crc};
+    out.write((const char*)c, 4);
+}
+
+static bool writePng(const std::string& path, int W, int H, const std::vector<unsigned char>& rgb) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) { std::cerr << "Failed to write output: " << path << "\n"; return false; }
+    static const unsigned char kSig[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    out.write((const char*)kSig, 8);
+    std::vector<unsigned char> ihdr = {
+        (unsigned char)(W >> 24), (unsigned char)(W >> 16), (unsigned char)(W >> 8), (unsigned char)W,
+        (unsigned char)(H >> 24), (unsigned char)(H >> 16), (unsigned char)(H >> 8), (unsigned char)H,
+        8, 2, 0, 0, 0 };                                    // 8-bit RGB, no interlace
+    writeChunk(out, "IHDR", ihdr);
+    std::vector<unsigned char> raw;
+    raw.reserve((size_t)H * (1 + 3 * (size_t)W));
+    for (int y = 0; y < H; ++y) {
+        raw.push_back(0);                                   // filter: none
+        raw.insert(raw.end(), rgb.begin() + (size_t)y * W * 3, rgb.begin() + (size_t)(y + 1) * W * 3);
+    }
+    writeChunk(out, "IDAT", deflateFixed(raw));
+    writeChunk(out, "IEND", {});
+    return (bool)out;
+}
+
+// ---------------- Raster ----------------
+struct PixRect { int x0, y0, x1, y1; }; // inclusive pixel bounds
+
+// Split [0, n) into `threads` contiguous chunks
+template <class Fn>
+static void parallelChunks(size_t n, int threads, Fn fn) {
+    if (threads <= 1 || n < 2) { fn(0, n, 0); return; }
+    std::vector<std::thread> pool;
+    const size_t chunk = (n + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        const size_t b = std::min(n, (size_t)t * chunk), e = std::min(n, b + chunk);
+        if (b < e) pool.emplace_back(fn, b, e, t);
+    }
+    for (auto& th : pool) th.join();
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+    if (argc < 3) { printUsage(); return 2; }
+    auto cfg = parseArgs(argc, argv);
+    if (cfg.inPath.empty()) { printUsage(); return 2; }
+    if (cfg.project != "none" && cfg.project != "mercator") {
+        std::cerr << "Unknown projection: " << cfg.project << "\n"; printUsage(); return 2;
+    }
+    if (cfg.width <= 0 || cfg.height < 0) { std::cerr << "Invalid image size\n"; return 2; }
+    if (cfg.size < 0.f || !std::isfinite(cfg.size)) { std::cerr << "Invalid --size\n"; return 2; }
+    const int threads = cfg.threads > 0 ? cfg.threads : (int)std::max(1u, std::thread::hardware_concurrency());
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<double> xs, ys; std::vector<float> side; std::vector<int> corner;
+    if (!readLabels(cfg, xs, ys, side, corner)) return 3;
+    if (xs.empty()) { std::cerr << "No points loaded.\n"; return 4; }
+    if (cfg.project == "mercator" && !isLq16(cfg.inPath)) projectLonLatToMercator(xs.data(), ys.data(), xs.size());
+
+    // One zoom level: labels drawn at their own thresholds would overlap where the layout has
+    // none, so without --size render the median labeled threshold (about half the labels)
+    float size = cfg.size;
+    if (!(size > 0.f)) {
+        std::vector<float> labeled;
+        for (float s : side) if (s > 0.f) labeled.push_back(s);
+        if (!labeled.empty()) {
+            std::nth_element(labeled.begin(), labeled.begin() + labeled.size() / 2, labeled.end());
+            size = labeled[labeled.size() / 2];
+        }
+    }
+
+    // Same local float32 frame as csv_labeler, so getAABB() sees the labeling geometry
+    std::vector<std::array<float,2>> points;
+    points = buildLocalFrame(xs, ys).offsets;
+    const size_t N = points.size();
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    // Label geometry at the requested size
+    std::vector<Rect> rects(N);
+    std::vector<unsigned char> shown(N, 0);
+    std::vector<std::array<float,4>> bounds(threads, {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                                                      std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()});
+    parallelChunks(N, threads, [&](size_t b, size_t e, int t) {
+        auto& bb = bounds[t];
+        for (size_t i = b; i < e; ++i) {
+            const auto& p = points[i];
+            bb[0] = std::min(bb[0], p[0]); bb[1] = std::min(bb[1], p[1]);
+            bb[2] = std::max(bb[2], p[0]); bb[3] = std::max(bb[3], p[1]);
+            if (!(side[i] > 0.f) || side[i] < size) continue;
+            LabelCandidate c{p, size, corner[i], 0.f, true};
+            rects[i] = getAABB(c);
+            shown[i] = 1;
+            bb[0] = std::min(bb[0], rects[i].xmin); bb[1] = std::min(bb[1], rects[i].ymin);
+            bb[2] = std::max(bb[2], rects[i].xmax); bb[3] = std::max(bb[3], rects[i].ymax);
+        }
+    });
+    float wx0 = bounds[0][0], wy0 = bounds[0][1], wx1 = bounds[0][2], wy1 = bounds[0][3];
+    for (const auto& bb : bounds) {
+        wx0 = std::min(wx0, bb[0]); wy0 = std::min(wy0, bb[1]);
+        wx1 = std::max(wx1, bb[2]); wy1 = std::max(wy1, bb[3]);
+    }
+    const float ww = std::max(wx1 - wx0, 1e-12f), wh = std::max(wy1 - wy0, 1e-12f);
+
+    const int W = cfg.width;
+    const int H = cfg.height > 0 ? cfg.height : std::max(1, std::min(16384, (int)std::lround(W * wh / ww)));
+    const float margin = 2.f;  // pixels, keeps border outlines visible
+    const float sc = std::min((W - 1 - 2 * margin) / ww, (H - 1 - 2 * margin) / wh);
+    auto px = [&](float x) { return (int)std::floor((x - wx0) * sc + margin); };
+    auto py = [&](float y) { return (int)std::floor((wy1 - y) * sc + margin); }; // image rows grow downward
+
+    // Pixel rects (y0 <= y1 after the flip)
+    std::vector<PixRect> prs(N);
+    parallelChunks(N, threads, [&](size_t b, size_t e, int) {
+        for (size_t i = b; i < e; ++i)
+            if (shown[i]) prs[i] = {px(rects[i].xmin), py(rects[i].ymax), px(rects[i].xmax), py(rects[i].ymin)};
+    });
+
+    // Each thread owns a horizontal band of rows. Outlines and points are binned by the bands
+    // their rows touch (counting sort, one pass to count and one to fill), so a band only
+    // visits its own items instead of all N.
+    std::vector<unsigned char> img((size_t)W * H * 3, 255);
+    const unsigned char kLabel[3] = {0, 110, 200};
+    const unsigned char kPoint[3] = {20, 20, 20};
+    const int bands = std::max(1, std::min(threads, H));
+    const int bandRows = (H + bands - 1) / bands;
+    const int bandCount = (H + bandRows - 1) / bandRows;
+    auto bandOf = [&](int y) { return std::min(bandCount - 1, std::max(0, y / bandRows)); };
+    const int lo = (cfg.pointPx - 1) / 2, hi = cfg.pointPx / 2;
+
+    // CSR bins: items of band k are binItems[binStart[k] .. binStart[k + 1])
+    auto binByBand = [&](auto rowsOf, std::vector<uint32_t>& binStart, std::vector<uint32_t>& binItems) {
+        binStart.assign((size_t)bandCount + 1, 0);
+        for (size_t i = 0; i < N; ++i) {
+            int y0, y1;
+            if (!rowsOf(i, y0, y1) || y1 < 0 || y0 >= H) continue;
+            for (int k = bandOf(y0); k <= bandOf(y1); ++k) ++binStart[k + 1];
+        }
+        for (int k = 0; k < bandCount; ++k) binStart[k + 1] += binStart[k];
+        binItems.resize(binStart[bandCount]);
+        std::vector<uint32_t> fill(binStart.begin(), binStart.end() - 1);
+        for (size_t i = 0; i < N; ++i) {
+            int y0, y1;
+            if (!rowsOf(i, y0, y1) || y1 < 0 || y0 >= H) continue;
+            for (int k = bandOf(y0); k <= bandOf(y1); ++k) binItems[fill[k]++] = (uint32_t)i;
+        }
+    };
+    std::vector<uint32_t> rectStart, rectItems, pointStart, pointItems;
+    binByBand([&](size_t i, int& y0, int& y1) {
+        if (!shown[i]) return false;
+        y0 = prs[i].y0; y1 = prs[i].y1; return true;
+    }, rectStart, rectItems);
+    if (cfg.pointPx > 0) {
+        binByBand([&](size_t i, int& y0, int& y1) {
+            const int cy = py(points[i][1]);
+            y0 = cy - lo; y1 = cy + hi; return true;
+        }, pointStart, pointItems);
+    }
+
+    auto drawBand = [&](int k) {
+        const int r0 = k * bandRows, r1 = std::min(H, r0 + bandRows) - 1;
+        auto put = [&](int x, int y, const unsigned char* c) {
+            unsigned char* d = &img[((size_t)y * W + x) * 3];
+            d[0] = c[0]; d[1] = c[1]; d[2] = c[2];
+        };
+        auto hline = [&](int y, int x0, int x1) {
+            if (y < r0 || y > r1) return;
+            for (int x = std::max(0, x0); x <= std::min(W - 1, x1); ++x) put(x, y, kLabel);
+        };
+        auto vline = [&](int x, int y0, int y1) {
+            if (x < 0 || x >= W) return;
+            for (int y = std::max(r0, y0); y <= std::min(r1, y1); ++y) put(x, y, kLabel);
+        };
+        for (uint32_t j = rectStart[k]; j < rectStart[k + 1]; ++j) {
+            const PixRect& r = prs[rectItems[j]];
+            hline(r.y0, r.x0, r.x1); hline(r.y1, r.x0, r.x1);
+            vline(r.x0, r.y0, r.y1); vline(r.x1, r.y0, r.y1);
+        }
+        if (cfg.pointPx <= 0) return;
+        for (uint32_t j = pointStart[k]; j < pointStart[k + 1]; ++j) {
+            const size_t i = pointItems[j];
+            const int cx = px(points[i][0]), cy = py(points[i][1]);
+            for (int y = std::max(r0, cy - lo); y <= std::min(r1, cy + hi); ++y)
+                for (int x = std::max(0, cx - lo); x <= std::min(W - 1, cx + hi); ++x) put(x, y, kPoint);
+        }
+    };
+    parallelChunks((size_t)bandCount, bands, [&](size_t kb, size_t ke, int) {
+        for (size_t k = kb; k < ke; ++k) drawBand((int)k);
+    });
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    if (!writePng(cfg.outPath, W, H, img)) return 5;
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    size_t labels = 0; for (unsigned char s : shown) labels += s;
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    std::cout << "Points: " << N << " labels=" << labels << " size=" << size << (cfg.size > 0.f ? "" : " (median)")
+              << " image=" << W << "x" << H << " threads=" << threads << "\n";
+    std::cout << "Time(ms): load=" << ms(t0, t1) << " raster=" << ms(t1, t2) << " png=" << ms(t2, t3) << "\n";
+    std::cout << "Wrote " << cfg.outPath << "\n";
+    return 0;
+}
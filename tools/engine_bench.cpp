@@ -0,0 +1,118 @@
+#include "greedy_labeler.hpp"
+#include "engine_planner.hpp"
+#include "zoom_thresholds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Threshold-engine benchmark: times the search and monotone engines (csv_labeler defaults,
+// planner placement options) on generated uniform and clustered sets; the planner's engine
+// thresholds in engine_planner.cpp come from this table. Each engine is rerun untimed with the
+// default placement options, and the *_same columns report whether the planner's options gave
+// identical thresholds and corners (the engines themselves differ by design).
+
+struct ArgsConfig {
+    std::vector<int> sizes = {5000, 10000, 20000, 40000, 80000};
+    std::vector<int> clusters = {0, 64, 8}; // 0 = uniform
+    int seed = 1;
+};
+
+static void printUsage(){
+    std::cerr << "Usage: engine_bench [options]\n"
+              << "Options:\n"
+              << "  --sizes a,b,...     Point counts (default 5000,10000,20000,40000,80000)\n"
+              << "  --clusters a,b,...  Cluster counts per set, 0 = uniform (default 0,64,8)\n"
+              << "  --seed s            Generator seed (default 1)\n"
+              << std::endl;
+}
+
+static std::vector<int> parseList(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(std::stoi(item));
+    return out;
+}
+
+static ArgsConfig parseArgs(int argc, char** argv) {
+    ArgsConfig cfg;
+    for (int i=1;i<argc;++i) {
+        std::string a = argv[i];
+        auto need = [&](int &i){ if(i+1>=argc){ std::cerr<<"Missing value after "<<a<<"\n"; return false;} return true; };
+        if (a == "--sizes" && need(i)) { cfg.sizes = parseList(argv[++i]); }
+        else if (a == "--clusters" && need(i)) { cfg.clusters = parseList(argv[++i]); }
+        else if (a == "--seed" && need(i)) { cfg.seed = std::stoi(argv[++i]); }
+        else if (a == "--help" || a == "-h") { printUsage(); std::exit(0); }
+    }
+    return cfg;
+}
+
+// n points in [0,100]^2: uniform, or `clusters` Gaussian clusters (sigma 0.5..4)
+static std::vector<std::array<float,2>> makePoints(int n, int clusters, int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> U(0.f, 100.f), R(0.5f, 4.f);
+    std::vector<std::array<float,2>> pts;
+    pts.reserve(n);
+    if (clusters <= 0) {
+        for (int i = 0; i < n; ++i) pts.push_back({U(rng), U(rng)});
+        return pts;
+    }
+    std::vector<std::array<float,3>> c;
+    for (int k = 0; k < clusters; ++k) c.push_back({U(rng), U(rng), R(rng)});
+    for (int i = 0; i < n; ++i) {
+        const auto& ck = c[i % clusters];
+        std::normal_distribution<float> G(0.f, ck[2]);
+        pts.push_back({ck[0] + G(rng), ck[1] + G(rng)});
+    }
+    return pts;
+}
+
+static bool sameResult(const ThresholdResult& a, const ThresholdResult& b) {
+    return a.size == b.size && a.corner == b.corner;
+}
+
+int main(int argc, char** argv) {
+    const ArgsConfig cfg = parseArgs(argc, argv);
+    std::cout << "n,clusters,skew,search_ms,monotone_ms,faster,search_same,monotone_same\n";
+    int mismatches = 0;
+    for (int n : cfg.sizes) {
+        for (int clusters : cfg.clusters) {
+            const auto pts = makePoints(n, clusters, cfg.seed);
+            const EnginePlan plan = planEngine(pts, 1);
+
+            float minX = pts[0][0], maxX = minX, minY = pts[0][1], maxY = minY;
+            for (const auto& p : pts) {
+                minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]);
+                minY = std::min(minY, p[1]); maxY = std::max(maxY, p[1]);
+            }
+            const float span = std::max(maxX - minX, maxY - minY);
+            const float Smin = 1e-4f, Smax = span, eps = span * 6e-5f + 1e-6f; // csv_labeler defaults
+
+            auto t0 = std::chrono::steady_clock::now();
+            const ThresholdResult search = computeZoomThresholds(pts, Smin, Smax, eps, 1.2f, 56, 64, true, 0, 0.f, plan.placement);
+            auto t1 = std::chrono::steady_clock::now();
+            const ThresholdResult mono = computeZoomThresholdsMonotone(pts, Smin, Smax, 1.2f, 56, 4, plan.placement);
+            auto t2 = std::chrono::steady_clock::now();
+
+            const PlacementOptions plain;
+            const bool searchSame = sameResult(search, computeZoomThresholds(pts, Smin, Smax, eps, 1.2f, 56, 64, true, 0, 0.f, plain));
+            const bool monoSame = sameResult(mono, computeZoomThresholdsMonotone(pts, Smin, Smax, 1.2f, 56, 4, plain));
+            mismatches += !searchSame + !monoSame;
+
+            const double searchMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            const double monoMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+            std::cout << n << "," << clusters << "," << plan.stats.occupancySkew << ","
+                      << searchMs << "," << monoMs << ","
+                      << (monoMs < searchMs ? "monotone" : "search") << ","
+                      << (searchSame ? "yes" : "NO") << "," << (monoSame ? "yes" : "NO") << std::endl;
+        }
+    }
+    return mismatches ? 1 : 0;
+}